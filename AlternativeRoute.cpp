@@ -1,73 +1,49 @@
 #include "AlternativeRoute.h"
 #include "EnvFriendlyRoute.h"
 #include "data_structures/Graph.h"
-#include <unordered_set>
-#include <iostream>
+#include <algorithm>
 
-std::vector<EnvFriendlyRoute> AlternativeRoute::findTwoSolutions(
-    Graph<int>& graph,
+// Shared by the Graph<int> and CsrGraph entry points
+template <class G>
+std::vector<EnvFriendlyRoute> findTwoSolutionsOn(
+    const G& graph,
     int source,
     int destination,
     double maxWalkTime,
     const std::vector<int>& avoidNodes,
-    const std::vector<std::pair<int, int>>& avoidSegments) {
-
-    std::vector<EnvFriendlyRoute> twosolutions;
-    std::unordered_set<int> usedParkingNodes;  // Track used parking nodes
-
-    // Find the best route
-    EnvFriendlyRoute bestRoute = findEnvFriendlyRoute(graph, source, destination, maxWalkTime, avoidNodes, avoidSegments);
-
-    // If the best route is valid, add it
-    if (bestRoute.parkingNode != -1) {
-        twosolutions.push_back(bestRoute);
-        usedParkingNodes.insert(bestRoute.parkingNode);
-    }
-
-    // Check if the best route has alternatives and add them
-    for (const auto& alt : bestRoute.alternatives) {
-        if (twosolutions.size() < 2 && usedParkingNodes.find(alt.parkingNode) == usedParkingNodes.end()) {
-            twosolutions.push_back(alt);
-            usedParkingNodes.insert(alt.parkingNode);
-        }
-    }
+    const std::vector<std::pair<int, int>>& avoidSegments,
+    SearchWorkspace& driveWs,
+    SearchWorkspace& walkWs) {
 
-    // If not enough solutions, continue searching with increased walking time
-    double currentMaxWalkTime = maxWalkTime;
-    int attemptCount = 0;
+    // Walking-time limits tried, in order: maxWalkTime, maxWalkTime + 5, ..., maxWalkTime + 100
+    const double walkStep = 5;
     const int maxAttempts = 20;
 
-    while (twosolutions.size() < 2 && attemptCount < maxAttempts) {
-        currentMaxWalkTime += 5;  // Increment walking time
-        attemptCount++;
-
-        EnvFriendlyRoute altRoute = findEnvFriendlyRoute(graph, source, destination, currentMaxWalkTime, avoidNodes, avoidSegments);
-
-        if (altRoute.parkingNode != -1) {
-            // Check if the main route is distinct
-            if (usedParkingNodes.find(altRoute.parkingNode) == usedParkingNodes.end()) {
-                twosolutions.push_back(altRoute);
-                usedParkingNodes.insert(altRoute.parkingNode);
-            }
+    // One pair of searches covers every limit: the options within a smaller limit are a
+    // subset of those within the largest one
+    auto options = findParkingOptions(graph, source, destination, maxWalkTime + walkStep * maxAttempts,
+                                      avoidNodes, avoidSegments, driveWs, walkWs);
+    sortParkingOptions(options);
 
-            // Now, check inside its alternatives
-            for (const auto& alt : altRoute.alternatives) {
-                if (twosolutions.size() < 2 && usedParkingNodes.find(alt.parkingNode) == usedParkingNodes.end()) {
-                    twosolutions.push_back(alt);
-                    usedParkingNodes.insert(alt.parkingNode);
-                }
+    // Sweep the limits; at each one the env query would return the first two options that fit
+    // (its best route and its alternative). Keep those with a parking node not used yet.
+    std::vector<const ParkingOption*> chosen;
+    double currentMaxWalkTime = maxWalkTime;
+    for (int attemptCount = 0; attemptCount <= maxAttempts && chosen.size() < 2; attemptCount++) {
+        int returned = 0;
+        for (const auto& option : options) {
+            if (option.walkingTime > currentMaxWalkTime) continue;
+            if (chosen.size() < 2 && std::find(chosen.begin(), chosen.end(), &option) == chosen.end()) {
+                chosen.push_back(&option);
             }
+            if (++returned == 2) break;
         }
+        currentMaxWalkTime += walkStep;  // Increment walking time
+    }
 
-        // Nested check: If we still need more solutions, check inside alternatives
-        if (twosolutions.size() < 2 && !twosolutions.empty()) {
-            for (const auto& alt : twosolutions.front().alternatives) {
-                if (twosolutions.size() < 2 && usedParkingNodes.find(alt.parkingNode) == usedParkingNodes.end()) {
-                    twosolutions.push_back(alt);
-                    usedParkingNodes.insert(alt.parkingNode);
-                }
-            }
-        }
+    std::vector<EnvFriendlyRoute> twosolutions;
+    for (const auto* option : chosen) {
+        twosolutions.push_back(makeEnvRoute(graph, *option, driveWs, walkWs));
     }
 
     // **Sorting to prioritize best solutions**
@@ -79,3 +55,27 @@ std::vector<EnvFriendlyRoute> AlternativeRoute::findTwoSolutions(
 
     return twosolutions;
 }
+
+std::vector<EnvFriendlyRoute> AlternativeRoute::findTwoSolutions(
+    const Graph<int>& graph,
+    int source,
+    int destination,
+    double maxWalkTime,
+    const std::vector<int>& avoidNodes,
+    const std::vector<std::pair<int, int>>& avoidSegments,
+    SearchWorkspace& driveWs,
+    SearchWorkspace& walkWs) {
+    return findTwoSolutionsOn(graph, source, destination, maxWalkTime, avoidNodes, avoidSegments, driveWs, walkWs);
+}
+
+std::vector<EnvFriendlyRoute> AlternativeRoute::findTwoSolutions(
+    const CsrGraph& graph,
+    int source,
+    int destination,
+    double maxWalkTime,
+    const std::vector<int>& avoidNodes,
+    const std::vector<std::pair<int, int>>& avoidSegments,
+    SearchWorkspace& driveWs,
+    SearchWorkspace& walkWs) {
+    return findTwoSolutionsOn(graph, source, destination, maxWalkTime, avoidNodes, avoidSegments, driveWs, walkWs);
+}
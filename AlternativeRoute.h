@@ -5,17 +5,33 @@
 #include <utility>  // For std::pair
 #include "EnvFriendlyRoute.h"
 #include "data_structures/Graph.h"
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
 
 class AlternativeRoute {
 public:
     // Declare the function to find alternative routes
     static std::vector<EnvFriendlyRoute> findTwoSolutions(
-        Graph<int>& graph,
+        const Graph<int>& graph,
         int source,
         int destination,
         double maxWalkTime,
         const std::vector<int>& avoidNodes,
-        const std::vector<std::pair<int, int>>& avoidSegments
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs = SearchWorkspace::forThread(0),
+        SearchWorkspace& walkWs = SearchWorkspace::forThread(1)
+    );
+
+    // Same search answered on an immutable CSR snapshot
+    static std::vector<EnvFriendlyRoute> findTwoSolutions(
+        const CsrGraph& graph,
+        int source,
+        int destination,
+        double maxWalkTime,
+        const std::vector<int>& avoidNodes,
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs = SearchWorkspace::forThread(0),
+        SearchWorkspace& walkWs = SearchWorkspace::forThread(1)
     );
 };
 
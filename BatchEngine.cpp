@@ -0,0 +1,313 @@
+#include "BatchEngine.h"
+#include "BestRoute.h"
+#include "RestrictedRoute.h"
+#include "EnvFriendlyRoute.h"
+#include "AlternativeRoute.h"
+#include "ParetoRoute.h"
+#include "DrivingAlternatives.h"
+#include "KShortestPaths.h"
+#include "WaypointTour.h"
+#include "DistanceMatrix.h"
+#include "MultimodalRoute.h"
+#include "data_structures/ThreadPool.h"
+#include <sstream>
+
+using namespace std;
+
+vector<BatchQuery> parseBatchQueries(istream &in) {
+    vector<BatchQuery> queries;
+    string line;
+    while (getline(in, line)) {
+        if (!line.starts_with("Mode:")) continue;
+
+        BatchQuery q;
+        q.mode = line.substr(5);
+
+        // Read block
+        while (getline(in, line) && !line.starts_with("---")) {
+            if (line.starts_with("Source:")) {
+                q.source = stoi(line.substr(7));
+            } else if (line.starts_with("Destination:")) {
+                q.destination = stoi(line.substr(12));
+            } else if (line.starts_with("AvoidNodes:")) {
+                q.avoidNodes.clear();
+                stringstream ss(line.substr(11));
+                string tok;
+                while (getline(ss, tok, ',')) {
+                    if (!tok.empty()) q.avoidNodes.push_back(stoi(tok));
+                }
+            } else if (line.starts_with("AvoidSegments:")) {
+                q.avoidSegments.clear();
+                stringstream ss(line.substr(14));
+                string seg;
+                while (ss >> seg) {
+                    if (seg.front() == '(' && seg.back() == ')') {
+                        seg = seg.substr(1, seg.size() - 2);
+                        size_t comma = seg.find(',');
+                        if (comma != string::npos) {
+                            int a = stoi(seg.substr(0, comma));
+                            int b = stoi(seg.substr(comma + 1));
+                            q.avoidSegments.emplace_back(a, b);
+                        }
+                    }
+                }
+            } else if (line.starts_with("IncludeNodes:")) {
+                q.includeNodes.clear();
+                stringstream ss(line.substr(13));
+                string tok;
+                while (getline(ss, tok, ',')) {
+                    if (!tok.empty()) q.includeNodes.push_back(stoi(tok));
+                }
+            } else if (line.starts_with("Sources:")) {
+                q.sources.clear();
+                stringstream ss(line.substr(8));
+                string tok;
+                while (getline(ss, tok, ',')) {
+                    if (!tok.empty()) q.sources.push_back(stoi(tok));
+                }
+            } else if (line.starts_with("Targets:")) {
+                q.targets.clear();
+                stringstream ss(line.substr(8));
+                string tok;
+                while (getline(ss, tok, ',')) {
+                    if (!tok.empty()) q.targets.push_back(stoi(tok));
+                }
+            } else if (line.starts_with("MatrixFile:")) {
+                q.matrixFile = line.substr(11);
+            } else if (line.starts_with("IncludeNode:")) {
+                q.includeNode = stoi(line.substr(12));
+            } else if (line.starts_with("MaxWalkTime:")) {
+                q.maxWalk = stod(line.substr(13));
+            } else if (line.starts_with("Alternatives:")) {
+                q.numAlternatives = stoi(line.substr(13));
+            }
+        }
+        queries.push_back(std::move(q));
+    }
+    return queries;
+}
+
+/*
+ * Writes ids as a comma-separated list.
+ */
+void writePath(ostream &out, const vector<int> &path) {
+    for (size_t i = 0; i < path.size(); ++i) {
+        out << path[i] << (i + 1 < path.size() ? "," : "");
+    }
+}
+
+/*
+ * Writes the lines of an env route (or its failure message).
+ */
+void writeEnvRoute(ostream &out, const EnvFriendlyRoute &route) {
+    if (route.parkingNode == -1) {
+        out << "DrivingRoute:none\nParkingNode:none\nWalkingRoute:none\nTotalTime:\nMessage:" << route.message << "\n";
+        return;
+    }
+    out << "DrivingRoute:";
+    writePath(out, route.drivingPath);
+    out << "(" << route.drivingTime << ")\n";
+
+    out << "ParkingNode:" << route.parkingNode << "\n";
+
+    out << "WalkingRoute:";
+    writePath(out, route.walkingPath);
+    out << "(" << route.walkingTime << ")\n";
+
+    out << "TotalTime:" << route.totalTime << "\n";
+}
+
+string solveBatchQuery(const CsrGraph &graph, const BatchQuery &q, SearchWorkspace &driveWs, SearchWorkspace &walkWs,
+                       const RoutingEngines &engines) {
+    ostringstream out;
+    int source = q.source, destination = q.destination;
+
+    if (q.mode == "driving") {
+        double bestTime, altTime;
+        auto bestPath = engines.table ? engines.table->findBestRoute(source, destination, bestTime)
+                      : engines.ch ? engines.ch->findBestRoute(source, destination, bestTime, driveWs, walkWs)
+                      : findBestRoute(graph, source, destination, bestTime, driveWs, walkWs);
+        auto altPath = bestPath.empty() ? vector<int>() : findAlternativeRoute(graph, source, destination, bestPath, altTime, driveWs, walkWs);
+        out << "Source:" << source << "\nDestination:" << destination << "\n";
+        if (bestPath.empty()) {
+            out << "BestDrivingRoute:none\nAlternativeDrivingRoute:none\n";
+        } else {
+            out << "BestDrivingRoute:";
+            writePath(out, bestPath);
+            out << "(" << bestTime << ")\n";
+
+            if (altPath.empty()) {
+                out << "AlternativeDrivingRoute:none\n";
+            } else {
+                out << "AlternativeDrivingRoute:";
+                writePath(out, altPath);
+                out << "(" << altTime << ")\n";
+            }
+        }
+    } else if (q.mode == "driving_alternatives") {
+        auto routes = findDrivingAlternatives(graph, source, destination, q.numAlternatives, {}, driveWs, walkWs);
+        out << "Source:" << source << "\nDestination:" << destination << "\n";
+        if (routes.empty()) {
+            out << "BestDrivingRoute:none\nAlternativeDrivingRoute:none\n";
+        } else {
+            out << "BestDrivingRoute:";
+            writePath(out, routes[0].path);
+            out << "(" << routes[0].time << ")\n";
+
+            if (routes.size() == 1) out << "AlternativeDrivingRoute:none\n";
+            for (size_t i = 1; i < routes.size(); ++i) {
+                out << "AlternativeDrivingRoute" << i << ":";
+                writePath(out, routes[i].path);
+                out << "(" << routes[i].time << ")\n";
+            }
+        }
+    } else if (q.mode == "driving_kshortest") {
+        out << "Source:" << source << "\nDestination:" << destination << "\n";
+        int rank = 0;
+        for (auto &route : kShortestPaths(graph, source, destination, q.avoidNodes, q.avoidSegments)) {
+            out << "DrivingRoute" << ++rank << ":";
+            writePath(out, route.path);
+            out << "(" << route.time << ")\n";
+            if (rank > q.numAlternatives) break;
+        }
+        if (rank == 0) out << "DrivingRoute:none\n";
+    } else if (q.mode == "restricted" || q.mode == "restricted_tour") {
+        // IncludeNode: is the one-waypoint form of IncludeNodes:
+        vector<int> includeNodes = q.includeNodes;
+        if (includeNodes.empty() && q.includeNode != -1) includeNodes.push_back(q.includeNode);
+        vector<int> path;
+        if (q.mode == "restricted_tour") {
+            path = optimizedWaypointRoute(graph, source, destination, includeNodes, q.avoidNodes, q.avoidSegments,
+                                          chrono::milliseconds(1000), driveWs, walkWs);
+        } else if (engines.landmarks) {
+            path = engines.landmarks->waypointDrivingRoute(source, destination, includeNodes, q.avoidNodes, q.avoidSegments, driveWs);
+        } else {
+            path = waypointDrivingRoute(graph, source, destination, includeNodes, q.avoidNodes, q.avoidSegments, driveWs, walkWs);
+        }
+        out << "Source:" << source << "\nDestination:" << destination << "\n";
+        if (path.empty()) {
+            out << "RestrictedDrivingRoute:none\n";
+        } else {
+            out << "RestrictedDrivingRoute:";
+            writePath(out, path);
+            int totalTime = 0;
+            for (size_t i = 0; i + 1 < path.size(); ++i) {
+                int u = graph.getIndex(path[i]);
+                int v = graph.getIndex(path[i + 1]);
+                for (int e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                    if (graph.getTarget(e) == v) {
+                        totalTime += graph.getDrivingWeight(e);
+                        break;
+                    }
+                }
+            }
+            out << "(" << totalTime << ")\n";
+        }
+    } else if (q.mode == "env") {
+        bool plain = q.avoidNodes.empty() && q.avoidSegments.empty();
+        auto route = engines.table && plain
+                ? engines.table->findEnvFriendlyRoute(source, destination, q.maxWalk)
+                : engines.landmarks
+                ? engines.landmarks->findEnvFriendlyRoute(source, destination, q.maxWalk, q.avoidNodes, q.avoidSegments, driveWs, walkWs)
+                : findEnvFriendlyRoute(graph, source, destination, q.maxWalk, q.avoidNodes, q.avoidSegments, driveWs, walkWs);
+        out << "Source:" << source << "\nDestination:" << destination << "\n";
+        writeEnvRoute(out, route);
+    } else if (q.mode == "env_multimodal") {
+        auto route = findMultimodalRoute(graph, source, destination, q.maxWalk, q.avoidNodes, q.avoidSegments,
+                                         engines.landmarks, driveWs);
+        out << "Source:" << source << "\nDestination:" << destination << "\n";
+        writeEnvRoute(out, route);
+    } else if (q.mode == "env_alt") {
+        auto results = AlternativeRoute::findTwoSolutions(graph, source, destination, q.maxWalk, q.avoidNodes, q.avoidSegments, driveWs, walkWs);
+        out << "Source:" << source << "\nDestination:" << destination << "\n";
+        if (results.empty()) {
+            out << "Message:No alternative routes found.\n";
+        } else {
+            for (size_t i = 0; i < results.size(); ++i) {
+                const auto& r = results[i];
+                out << "DrivingRoute" << (i+1) << ":";
+                writePath(out, r.drivingPath);
+                out << "(" << r.drivingTime << ")\n";
+                out << "ParkingNode" << (i+1) << ":" << r.parkingNode << "\n";
+                out << "WalkingRoute" << (i+1) << ":";
+                writePath(out, r.walkingPath);
+                out << "(" << r.walkingTime << ")\n";
+                out << "TotalTime" << (i+1) << ":" << r.totalTime << "\n";
+            }
+        }
+    } else if (q.mode == "env_pareto") {
+        auto front = findParetoEnvRoutes(graph, source, destination, q.maxWalk, q.avoidNodes, q.avoidSegments, driveWs, walkWs);
+        out << "Source:" << source << "\nDestination:" << destination << "\n";
+        if (front.empty()) {
+            out << "Message:No driving and walking route within max walking time.\n";
+        } else {
+            for (size_t i = 0; i < front.size(); ++i) {
+                const auto& r = front[i];
+                out << "DrivingRoute" << (i+1) << ":";
+                writePath(out, r.drivingPath);
+                out << "(" << r.drivingTime << ")\n";
+                out << "ParkingNode" << (i+1) << ":" << r.parkingNode << "\n";
+                out << "WalkingRoute" << (i+1) << ":";
+                writePath(out, r.walkingPath);
+                out << "(" << r.walkingTime << ")\n";
+                out << "TotalTime" << (i+1) << ":" << r.totalTime << "\n";
+            }
+        }
+    } else if (q.mode == "matrix") {
+        // Queries already run in parallel, so each matrix is filled on its own worker
+        vector<double> times(q.sources.size() * q.targets.size());
+        if (engines.ch) engines.ch->distanceMatrix(q.sources, q.targets, times.data(), 1);
+        else distanceMatrix(graph, q.sources, q.targets, times.data(), 1);
+        out << "Sources:";
+        writePath(out, q.sources);
+        out << "\nTargets:";
+        writePath(out, q.targets);
+        out << "\n";
+        if (!q.matrixFile.empty()) {
+            if (writeMatrixBinary(q.matrixFile, q.sources.size(), q.targets.size(), times.data())) {
+                out << "MatrixFile:" << q.matrixFile << "\n";
+            } else {
+                out << "Message:Could not write " << q.matrixFile << ".\n";
+            }
+        } else {
+            out << "Matrix:\n";
+            writeMatrixCsv(out, q.sources, q.targets, times.data());
+        }
+    }
+    return out.str();
+}
+
+EngineNeeds neededEngines(const vector<BatchQuery> &queries, bool haveTable) {
+    // Mirrors the engine choices of solveBatchQuery
+    EngineNeeds needs;
+    for (const auto &q : queries) {
+        bool plain = q.avoidNodes.empty() && q.avoidSegments.empty();
+        if ((q.mode == "driving" && !haveTable) || q.mode == "matrix") needs.ch = true;
+        if (q.mode == "restricted" || q.mode == "env_multimodal" || (q.mode == "env" && !(haveTable && plain))) {
+            needs.landmarks = true;
+        }
+    }
+    return needs;
+}
+
+void runBatch(const CsrGraph &graph, istream &in, ostream &out, unsigned numThreads,
+              const RoutingEngines &engines) {
+    runBatch(graph, parseBatchQueries(in), out, numThreads, engines);
+}
+
+void runBatch(const CsrGraph &graph, const vector<BatchQuery> &queries, ostream &out, unsigned numThreads,
+              const RoutingEngines &engines) {
+    vector<string> results(queries.size());
+
+    ThreadPool pool(numThreads);
+    vector<SearchWorkspace> driveWs(pool.size()), walkWs(pool.size());
+
+    pool.parallelFor(queries.size(), [&](int i, unsigned worker) {
+        results[i] = solveBatchQuery(graph, queries[i], driveWs[worker], walkWs[worker], engines);
+    });
+
+    // Results are collected by position, so the output keeps the input order
+    for (const auto &block : results) {
+        out << block << "\n---\n";
+    }
+}
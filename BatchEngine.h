@@ -0,0 +1,87 @@
+#ifndef BATCH_ENGINE_H
+#define BATCH_ENGINE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
+#include "ContractionHierarchy.h"
+#include "LandmarkIndex.h"
+#include "DistanceTable.h"
+
+/**
+ * One "Mode:" block of a batch input file.
+ */
+struct BatchQuery {
+    // driving, driving_alternatives, driving_kshortest, restricted, restricted_tour (waypoints in any
+    // order), env, env_multimodal (env answered by the layered search), env_alt, env_pareto or matrix
+    std::string mode;
+    int source = -1;
+    int destination = -1;
+    int includeNode = -1;
+    std::vector<int> includeNodes; // ordered waypoints of a restricted route (IncludeNodes:)
+    // Alternatives: routes after the best one, so driving_alternatives and driving_kshortest print
+    // the best route plus up to numAlternatives more
+    int numAlternatives = 3;
+    double maxWalk = 0;
+    std::vector<int> avoidNodes;
+    std::vector<std::pair<int, int>> avoidSegments;
+    std::vector<int> sources;      // matrix rows (Sources:)
+    std::vector<int> targets;      // matrix columns (Targets:)
+    std::string matrixFile;        // binary matrix output instead of inline CSV (MatrixFile:)
+};
+
+/**
+ * Optional preprocessed indices over the same snapshot. A missing index falls back to the
+ * plain CsrGraph searches.
+ */
+struct RoutingEngines {
+    const ContractionHierarchy *ch = nullptr;  // driving best routes and matrices
+    const LandmarkIndex *landmarks = nullptr;  // restricted and env routes (both env engines)
+    const DistanceTable *table = nullptr;      // driving best routes and env routes without avoid lists
+};
+
+/**
+ * Optional indices a set of queries would use.
+ */
+struct EngineNeeds {
+    bool ch = false;
+    bool landmarks = false;
+};
+
+/**
+ * Parses every "Mode:" block of a batch input, in file order.
+ * A block ends at a line starting with "---" (or at the end of the input).
+ */
+std::vector<BatchQuery> parseBatchQueries(std::istream &in);
+
+/**
+ * Solves a single query and returns its output block, without the trailing separator.
+ * Unknown modes produce an empty block.
+ */
+std::string solveBatchQuery(const CsrGraph &graph, const BatchQuery &query, SearchWorkspace &driveWs, SearchWorkspace &walkWs,
+                            const RoutingEngines &engines = {});
+
+/**
+ * Which of the contraction hierarchy and the landmark index solveBatchQuery would use for
+ * queries, given whether a distance table is loaded (it answers driving best routes and env
+ * routes without avoid lists by itself). Lets a batch run skip preprocessing nothing needs.
+ */
+EngineNeeds neededEngines(const std::vector<BatchQuery> &queries, bool haveTable);
+
+/**
+ * Spreads the queries over numThreads workers (0 = one per hardware thread), each with its own
+ * search workspaces, and writes the blocks to out in input order.
+ */
+void runBatch(const CsrGraph &graph, const std::vector<BatchQuery> &queries, std::ostream &out, unsigned numThreads,
+              const RoutingEngines &engines = {});
+
+/**
+ * Parses the whole input and runs it as above.
+ */
+void runBatch(const CsrGraph &graph, std::istream &in, std::ostream &out, unsigned numThreads,
+              const RoutingEngines &engines = {});
+
+#endif // BATCH_ENGINE_H
@@ -1,107 +1,160 @@
 #include "BestRoute.h"
-#include "data_structures/MutablePriorityQueue.h"
-#include <unordered_map>
+#include "BidirectionalSearch.h"
+#include "data_structures/IndexedPriorityQueue.h"
+#include "data_structures/SearchQueue.h"
 #include <algorithm>
 #include <iostream>
 #include <vector>
 
 using namespace std;
 
-bool relax(Edge<int> *edge) {
-    auto u = edge->getOrig();
-    auto v = edge->getDest();
+bool relax(Edge<int> *edge, SearchWorkspace &ws) {
+    int u = edge->getOrig()->getIndex();
+    int v = edge->getDest()->getIndex();
     double weight = edge->getDrivingWeight();
-    if (u->getDist() + weight < v->getDist()) {
-        v->setDist(u->getDist() + weight);
-        v->setPath(edge);
+    if (ws.getDist(u) + weight < ws.getDist(v)) {
+        ws.setDist(v, ws.getDist(u) + weight);
+        ws.setParent(v, u);
         return true;
     }
     return false;
 }
 
-void dijkstra(Graph<int> &graph, int source) {
-    for (auto v : graph.getVertexSet()) {
-        v->setDist(INF);
-        v->setPath(nullptr);
-    }
-    auto s = graph.findVertex(source);
-    if (!s) return;
+/*
+ * Driving Dijkstra over the Graph<int>; blocked (if non-empty) flags dense indices that may not be entered.
+ */
+void dijkstra(const Graph<int> &graph, int source, const vector<char> &blocked, SearchWorkspace &ws) {
+    ws.reset(graph.getNumVertex());
+    int s = graph.findVertexIdx(source);
+    if (s == -1) return;
 
-    s->setDist(0);
-    MutablePriorityQueue<Vertex<int>> q;
+    ws.setDist(s, 0);
+    IndexedPriorityQueue q(ws);
     q.insert(s);
 
     while (!q.empty()) {
-        auto v = q.extractMin();
+        auto v = graph.getVertex(q.extractMin());
         for (auto e : v->getAdj()) {
-            auto oldDist = e->getDest()->getDist();
-            if (relax(e)) {
-                if (oldDist == INF) q.insert(e->getDest());
-                else q.decreaseKey(e->getDest());
+            int w = e->getDest()->getIndex();
+            if (!blocked.empty() && blocked[w]) continue;
+
+            auto oldDist = ws.getDist(w);
+            if (relax(e, ws)) {
+                if (oldDist == INF) q.insert(w);
+                else q.decreaseKey(w);
             }
         }
     }
 }
 
-vector<int> findBestRoute(Graph<int> &graph, int source, int destination, double &totalTime) {
-
+vector<int> buildPath(const Graph<int> &graph, const SearchWorkspace &ws, int t) {
     vector<int> path;
-    dijkstra(graph, source);
-    auto v = graph.findVertex(destination);
-    if (!v || v->getDist() == INF) return {}; // Return empty vector if no path exists
-
-    while (v) {
-        path.push_back(v->getInfo());
-        if (!v->getPath()) break;
-        v = v->getPath()->getOrig();
+    for (int v = t; v != -1; v = ws.getParent(v)) {
+        path.push_back(graph.getVertex(v)->getInfo());
     }
     std::reverse(path.begin(), path.end());
-    totalTime = graph.findVertex(destination)->getDist();
     return path;
 }
 
-vector <int> findAlternativeRoute(Graph<int> &graph, int source, int destination, const std::vector<int> &bestPath, double &altTime) {
-    std::unordered_map<int, bool> bestPathNodes;
-    vector<int> altPath;
-    for (int node : bestPath) {
-        bestPathNodes[node] = true;
-    }
+vector<int> findBestRoute(const Graph<int> &graph, int source, int destination, double &totalTime, SearchWorkspace &ws) {
+    dijkstra(graph, source, {}, ws);
+    int t = graph.findVertexIdx(destination);
+    if (t == -1 || ws.getDist(t) == INF) return {}; // Return empty vector if no path exists
 
-    for (auto v : graph.getVertexSet()) {
-        v->setDist(INF);
-        v->setPath(nullptr);
-    }
+    totalTime = ws.getDist(t);
+    return buildPath(graph, ws, t);
+}
 
-    auto s = graph.findVertex(source);
-    if (!s) return {};
-    s->setDist(0);
+vector <int> findAlternativeRoute(const Graph<int> &graph, int source, int destination, const std::vector<int> &bestPath, double &altTime, SearchWorkspace &ws) {
+    vector<char> bestPathNodes(graph.getNumVertex(), 0); // indexed by dense vertex index
+    for (int node : bestPath) {
+        if (node == source || node == destination) continue;
+        int idx = graph.findVertexIdx(node);
+        if (idx != -1) bestPathNodes[idx] = 1;
+    }
 
-    MutablePriorityQueue<Vertex<int>> q;
-    q.insert(s);
+    dijkstra(graph, source, bestPathNodes, ws);
+    int t = graph.findVertexIdx(destination);
+    if (t == -1 || ws.getDist(t) == INF) return {};
 
-    while (!q.empty()) {
-        auto v = q.extractMin();
-        for (auto e : v->getAdj()) {
-            int vInfo = e->getDest()->getInfo();
-            if (bestPathNodes[vInfo] && vInfo != source && vInfo != destination) continue;
+    altTime = ws.getDist(t);
+    return buildPath(graph, ws, t);
+}
 
-            auto oldDist = e->getDest()->getDist();
-            if (relax(e)) {
-                if (oldDist == INF) q.insert(e->getDest());
-                else q.decreaseKey(e->getDest());
+void dijkstra(const CsrGraph &graph, int s, const vector<char> &blockedNodes, const vector<char> &blockedEdges,
+              SearchWorkspace &ws) {
+    ws.reset(graph.getNumVertex());
+    ws.setDist(s, 0);
+    withSearchQueue(graph, [&](auto makeQueue) {
+        auto q = makeQueue(ws);
+        q.insert(s);
+
+        while (!q.empty()) {
+            int v = q.extractMin();
+            double d = ws.getDist(v);
+            for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+                int w = graph.getTarget(e);
+                if (!blockedNodes.empty() && blockedNodes[w]) continue;
+                if (!blockedEdges.empty() && blockedEdges[e]) continue;
+                double weight = graph.getDrivingWeight(e);
+                if (weight == INF) continue;
+
+                auto oldDist = ws.getDist(w);
+                if (d + weight < oldDist) {
+                    ws.setDist(w, d + weight);
+                    ws.setParent(w, v);
+                    if (oldDist == INF) q.insert(w);
+                    else q.decreaseKey(w);
+                }
             }
         }
+    });
+}
+
+void appendCsrPath(const CsrGraph &graph, const SearchWorkspace &ws, int t, vector<int> &path) {
+    size_t first = path.size();
+    for (int v = t; v != -1; v = ws.getParent(v)) {
+        path.push_back(graph.getId(v));
     }
+    std::reverse(path.begin() + first, path.end());
+}
 
-    auto v = graph.findVertex(destination);
-    if (!v || v->getDist() == INF) return {};
+vector<int> buildCsrPath(const CsrGraph &graph, const SearchWorkspace &ws, int t) {
+    vector<int> path;
+    appendCsrPath(graph, ws, t, path);
+    return path;
+}
+
+vector<int> findBestRoute(const CsrGraph &graph, int source, int destination, double &totalTime,
+                          SearchWorkspace &ws, SearchWorkspace &backwardWs) {
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    if (s == -1 || t == -1) return {};
+
+    vector<int> path;
+    double dist = bidirectionalDijkstra(graph, s, t, {}, {}, ws, backwardWs, path);
+    if (dist == INF) return {}; // Return empty vector if no path exists
+
+    totalTime = dist;
+    return path;
+}
+
+vector<int> findAlternativeRoute(const CsrGraph &graph, int source, int destination, const std::vector<int> &bestPath, double &altTime,
+                                 SearchWorkspace &ws, SearchWorkspace &backwardWs) {
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    if (s == -1 || t == -1) return {};
 
-    while (v) {
-        altPath.push_back(v->getInfo());
-        if (!v->getPath()) break;
-        v = v->getPath()->getOrig();
+    vector<char> blocked(graph.getNumVertex(), 0);
+    for (int node : bestPath) {
+        int v = graph.getIndex(node);
+        if (v != -1 && v != s && v != t) blocked[v] = 1;
     }
-    std::reverse(altPath.begin(), altPath.end());
-    altTime = graph.findVertex(destination)->getDist();
-    return altPath;
-}
\ No newline at end of file
+
+    vector<int> path;
+    double dist = bidirectionalDijkstra(graph, s, t, blocked, {}, ws, backwardWs, path);
+    if (dist == INF) return {};
+
+    altTime = dist;
+    return path;
+}
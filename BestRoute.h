@@ -2,9 +2,44 @@
 #define BEST_ROUTE_H
 
 #include "data_structures/Graph.h"
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
 #include <vector>
 
-std::vector<int> findBestRoute(Graph<int> &graph, int source, int destination, double &totalTime);
-std::vector<int> findAlternativeRoute(Graph<int> &graph, int source, int destination, const std::vector<int> &bestPath, double &altTime);
+/**
+ * Search state lives in the given SearchWorkspace (by default the calling thread's own),
+ * so the graph is only read and can serve several queries concurrently.
+ */
+std::vector<int> findBestRoute(const Graph<int> &graph, int source, int destination, double &totalTime,
+                               SearchWorkspace &ws = SearchWorkspace::forThread());
+std::vector<int> findAlternativeRoute(const Graph<int> &graph, int source, int destination, const std::vector<int> &bestPath, double &altTime,
+                                      SearchWorkspace &ws = SearchWorkspace::forThread());
 
-#endif // BEST_ROUTE_H
\ No newline at end of file
+/**
+ * Same queries answered on an immutable CSR snapshot; source, destination and the
+ * returned paths use the CSV Ids, exactly like the Graph<int> versions.
+ * Both run a bidirectional point-to-point search (see BidirectionalSearch.h) that stops
+ * early instead of settling the whole graph.
+ */
+std::vector<int> findBestRoute(const CsrGraph &graph, int source, int destination, double &totalTime,
+                               SearchWorkspace &ws = SearchWorkspace::forThread(0),
+                               SearchWorkspace &backwardWs = SearchWorkspace::forThread(1));
+std::vector<int> findAlternativeRoute(const CsrGraph &graph, int source, int destination, const std::vector<int> &bestPath, double &altTime,
+                                      SearchWorkspace &ws = SearchWorkspace::forThread(0),
+                                      SearchWorkspace &backwardWs = SearchWorkspace::forThread(1));
+
+/**
+ * Driving Dijkstra from dense index s over the CSR snapshot; the resulting tree is left in ws.
+ * Vertices flagged in blockedNodes and edges flagged in blockedEdges are skipped; either mask may be empty.
+ */
+void dijkstra(const CsrGraph &graph, int s, const std::vector<char> &blockedNodes, const std::vector<char> &blockedEdges,
+              SearchWorkspace &ws);
+
+/**
+ * Walks the parents stored in ws back from dense index t and returns the path as CSV Ids.
+ * appendCsrPath writes it at the end of path instead.
+ */
+std::vector<int> buildCsrPath(const CsrGraph &graph, const SearchWorkspace &ws, int t);
+void appendCsrPath(const CsrGraph &graph, const SearchWorkspace &ws, int t, std::vector<int> &path);
+
+#endif // BEST_ROUTE_H
@@ -0,0 +1,86 @@
+#include "BidirectionalSearch.h"
+#include "data_structures/SearchQueue.h"
+#include <algorithm>
+
+using namespace std;
+
+double bidirectionalDijkstra(const CsrGraph &graph, int s, int t,
+                             const vector<char> &blockedNodes, const vector<char> &blockedEdges,
+                             SearchWorkspace &fws, SearchWorkspace &bws,
+                             vector<int> &path) {
+    auto isBlocked = [&](int v) { return !blockedNodes.empty() && blockedNodes[v] && v != s; };
+    if (isBlocked(t)) return INF;
+
+    fws.reset(graph.getNumVertex());
+    bws.reset(graph.getNumVertex());
+    double best = s == t ? 0 : INF;
+    int meet = s == t ? s : -1;
+    withSearchQueue(graph, [&](auto makeQueue) {
+        auto fq = makeQueue(fws);
+        auto bq = makeQueue(bws);
+        fws.setDist(s, 0);
+        fq.insert(s);
+        bws.setDist(t, 0);
+        bq.insert(t);
+
+        while (!fq.empty() && !bq.empty()) {
+            double forwardTop = fws.getDist(fq.peekMin());
+            double backwardTop = bws.getDist(bq.peekMin());
+            if (forwardTop + backwardTop >= best) break; // no unexplored s-t path can be shorter
+
+            if (forwardTop <= backwardTop) {
+                int v = fq.extractMin();
+                for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+                    int w = graph.getTarget(e);
+                    if (isBlocked(w)) continue;
+                    if (!blockedEdges.empty() && blockedEdges[e]) continue;
+                    double weight = graph.getDrivingWeight(e);
+                    if (weight == INF) continue;
+
+                    double d = forwardTop + weight;
+                    auto oldDist = fws.getDist(w);
+                    if (d < oldDist) {
+                        fws.setDist(w, d);
+                        fws.setParent(w, v);
+                        if (oldDist == INF) fq.insert(w);
+                        else fq.decreaseKey(w);
+                    }
+                    if (d + bws.getDist(w) < best) {
+                        best = d + bws.getDist(w);
+                        meet = w;
+                    }
+                }
+            } else {
+                int v = bq.extractMin();
+                for (int k = graph.inEdgeBegin(v); k < graph.inEdgeEnd(v); k++) {
+                    int u = graph.getInSource(k);
+                    int e = graph.getInEdge(k);
+                    if (isBlocked(u)) continue;
+                    if (!blockedEdges.empty() && blockedEdges[e]) continue;
+                    double weight = graph.getDrivingWeight(e);
+                    if (weight == INF) continue;
+
+                    double d = backwardTop + weight;
+                    auto oldDist = bws.getDist(u);
+                    if (d < oldDist) {
+                        bws.setDist(u, d);
+                        bws.setParent(u, v);
+                        if (oldDist == INF) bq.insert(u);
+                        else bq.decreaseKey(u);
+                    }
+                    if (d + fws.getDist(u) < best) {
+                        best = d + fws.getDist(u);
+                        meet = u;
+                    }
+                }
+            }
+        }
+    });
+    if (meet == -1) return INF;
+
+    size_t first = path.size();
+    for (int v = meet; v != -1; v = fws.getParent(v)) path.push_back(graph.getId(v));
+    reverse(path.begin() + first, path.end());
+    for (int v = bws.getParent(meet); v != -1; v = bws.getParent(v)) path.push_back(graph.getId(v));
+    return best;
+}
@@ -0,0 +1,24 @@
+#ifndef BIDIRECTIONAL_SEARCH_H
+#define BIDIRECTIONAL_SEARCH_H
+
+#include <vector>
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
+
+/**
+ * Point-to-point driving query between dense indices s and t.
+ * Searches forward from s over outgoing edges and backward from t over incoming edges,
+ * always expanding the side with the smaller queue head, and stops as soon as the two
+ * heads together can no longer beat the best meeting distance found so far.
+ *
+ * Vertices flagged in blockedNodes (other than s) and edges flagged in blockedEdges are
+ * never used; either mask may be empty. Returns the distance (INF if t is unreachable) and
+ * appends the CSV Ids of the route to path (nothing if unreachable), so legs of a longer
+ * route can be written one after another into the same vector.
+ */
+double bidirectionalDijkstra(const CsrGraph &graph, int s, int t,
+                             const std::vector<char> &blockedNodes, const std::vector<char> &blockedEdges,
+                             SearchWorkspace &forwardWs, SearchWorkspace &backwardWs,
+                             std::vector<int> &path);
+
+#endif // BIDIRECTIONAL_SEARCH_H
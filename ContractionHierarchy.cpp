@@ -0,0 +1,421 @@
+#include "ContractionHierarchy.h"
+#include "data_structures/DaryHeap.h"
+#include "data_structures/ThreadPool.h"
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+// Witness searches give up after settling this many vertices and keep the shortcut instead
+const int WITNESS_SETTLE_LIMIT = 500;
+
+struct ChArc {
+    int other;     // head for outgoing arcs, tail for incoming arcs
+    double weight;
+    int middle;    // contracted vertex this shortcut bypasses, -1 for an original edge
+};
+
+struct ChShortcut {
+    int from, to;
+    double weight;
+    int middle;
+};
+
+/*
+ * Mutable overlay graph used while contracting; only holds the vertices not contracted yet.
+ */
+struct ChBuilder {
+    vector<vector<ChArc>> out, in;
+    vector<char> contracted;
+    vector<char> selected;          // vertices contracted in the current level
+    vector<int> deletedNeighbours;
+    vector<int> priority;
+
+    explicit ChBuilder(const CsrGraph &graph);
+
+    /*
+     * Shortcuts needed to contract v; witness searches skip v and, if skipSelected is set,
+     * every vertex of the current level.
+     */
+    void findShortcuts(int v, bool skipSelected, SearchWorkspace &ws, vector<ChShortcut> &shortcuts) const;
+    void updatePriority(int v, SearchWorkspace &ws, vector<ChShortcut> &scratch);
+    bool isLocalMinimum(int v) const;
+};
+
+/*
+ * Inserts an arc, keeping only the lightest one between the same pair of vertices.
+ */
+void addOrImproveArc(vector<ChArc> &arcs, int other, double weight, int middle) {
+    for (auto &a : arcs) {
+        if (a.other == other) {
+            if (weight < a.weight) {
+                a.weight = weight;
+                a.middle = middle;
+            }
+            return;
+        }
+    }
+    arcs.push_back({other, weight, middle});
+}
+
+ChBuilder::ChBuilder(const CsrGraph &graph) {
+    int n = graph.getNumVertex();
+    out.resize(n);
+    in.resize(n);
+    contracted.assign(n, 0);
+    selected.assign(n, 0);
+    deletedNeighbours.assign(n, 0);
+    priority.assign(n, 0);
+
+    for (int v = 0; v < n; v++) {
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+            int w = graph.getTarget(e);
+            double weight = graph.getDrivingWeight(e);
+            if (weight == INF || w == v) continue;
+            addOrImproveArc(out[v], w, weight, -1);
+            addOrImproveArc(in[w], v, weight, -1);
+        }
+    }
+}
+
+void ChBuilder::findShortcuts(int v, bool skipSelected, SearchWorkspace &ws, vector<ChShortcut> &shortcuts) const {
+    shortcuts.clear();
+    if (out[v].empty()) return;
+
+    double maxOut = 0;
+    for (auto &o : out[v]) maxOut = max(maxOut, o.weight);
+
+    for (auto &i : in[v]) {
+        int u = i.other;
+        double limit = i.weight + maxOut;
+
+        // Local Dijkstra from u that may not pass through v
+        ws.reset(out.size());
+        ws.setDist(u, 0);
+        DaryHeap<4> q(ws);
+        q.insert(u);
+        int settled = 0;
+        while (!q.empty() && settled < WITNESS_SETTLE_LIMIT) {
+            int x = q.extractMin();
+            double d = ws.getDist(x);
+            if (d > limit) break;
+            settled++;
+            for (auto &a : out[x]) {
+                int y = a.other;
+                if (y == v || (skipSelected && selected[y])) continue;
+                auto oldDist = ws.getDist(y);
+                if (d + a.weight < oldDist) {
+                    ws.setDist(y, d + a.weight);
+                    if (oldDist == INF) q.insert(y);
+                    else q.decreaseKey(y);
+                }
+            }
+        }
+
+        for (auto &o : out[v]) {
+            int w = o.other;
+            if (w == u) continue;
+            double viaV = i.weight + o.weight;
+            if (ws.getDist(w) > viaV) {
+                shortcuts.push_back({u, w, viaV, v});
+            }
+        }
+    }
+}
+
+void ChBuilder::updatePriority(int v, SearchWorkspace &ws, vector<ChShortcut> &scratch) {
+    findShortcuts(v, false, ws, scratch);
+    int edgeDifference = (int) scratch.size() - (int) (in[v].size() + out[v].size());
+    priority[v] = edgeDifference + deletedNeighbours[v];
+}
+
+bool ChBuilder::isLocalMinimum(int v) const {
+    auto before = [this](int a, int b) {
+        return priority[a] < priority[b] || (priority[a] == priority[b] && a < b);
+    };
+    for (auto &a : out[v])
+        if (!before(v, a.other)) return false;
+    for (auto &a : in[v])
+        if (!before(v, a.other)) return false;
+    return true;
+}
+
+ContractionHierarchy::ContractionHierarchy(const CsrGraph &graph, unsigned numThreads): graph(graph) {
+    int n = graph.getNumVertex();
+    ChBuilder builder(graph);
+    ThreadPool pool(numThreads);
+    vector<SearchWorkspace> workspaces(pool.size());
+    vector<vector<ChShortcut>> scratch(pool.size());
+
+    vector<vector<ChArc>> up(n), down(n);
+    rank.assign(n, -1);
+
+    vector<int> remaining(n);
+    for (int v = 0; v < n; v++) remaining[v] = v;
+    pool.parallelFor(n, [&](int v, unsigned worker) {
+        builder.updatePriority(v, workspaces[worker], scratch[worker]);
+    });
+
+    int nextRank = 0;
+    while (!remaining.empty()) {
+        // 1. pick an independent set of local priority minima
+        vector<char> pick(remaining.size(), 0);
+        pool.parallelFor(remaining.size(), [&](int i, unsigned) {
+            pick[i] = builder.isLocalMinimum(remaining[i]);
+        });
+        vector<int> level, rest;
+        for (size_t i = 0; i < remaining.size(); i++) {
+            if (pick[i]) level.push_back(remaining[i]);
+            else rest.push_back(remaining[i]);
+        }
+        for (int v : level) builder.selected[v] = 1;
+
+        // 2. compute the shortcuts of the whole level in parallel
+        vector<vector<ChShortcut>> shortcuts(level.size());
+        pool.parallelFor(level.size(), [&](int i, unsigned worker) {
+            builder.findShortcuts(level[i], true, workspaces[worker], shortcuts[i]);
+        });
+
+        // 3. apply: freeze the arcs of each contracted vertex and splice in its shortcuts
+        vector<int> touched;
+        for (size_t i = 0; i < level.size(); i++) {
+            int v = level[i];
+            rank[v] = nextRank++;
+            up[v] = std::move(builder.out[v]);
+            down[v] = std::move(builder.in[v]);
+            builder.contracted[v] = 1;
+            builder.selected[v] = 0;
+
+            for (auto &a : up[v]) {
+                auto &arcs = builder.in[a.other];
+                arcs.erase(remove_if(arcs.begin(), arcs.end(), [v](const ChArc &x) { return x.other == v; }), arcs.end());
+                builder.deletedNeighbours[a.other]++;
+                touched.push_back(a.other);
+            }
+            for (auto &a : down[v]) {
+                auto &arcs = builder.out[a.other];
+                arcs.erase(remove_if(arcs.begin(), arcs.end(), [v](const ChArc &x) { return x.other == v; }), arcs.end());
+                builder.deletedNeighbours[a.other]++;
+                touched.push_back(a.other);
+            }
+            for (auto &s : shortcuts[i]) {
+                addOrImproveArc(builder.out[s.from], s.to, s.weight, s.middle);
+                addOrImproveArc(builder.in[s.to], s.from, s.weight, s.middle);
+            }
+            numShortcuts += shortcuts[i].size();
+        }
+
+        // 4. only the neighbours of contracted vertices change priority
+        sort(touched.begin(), touched.end());
+        touched.erase(unique(touched.begin(), touched.end()), touched.end());
+        pool.parallelFor(touched.size(), [&](int i, unsigned worker) {
+            builder.updatePriority(touched[i], workspaces[worker], scratch[worker]);
+        });
+
+        remaining = std::move(rest);
+    }
+
+    // Freeze the upward and downward arcs into CSR arrays
+    upOffsets.assign(n + 1, 0);
+    downOffsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        upOffsets[v + 1] = upOffsets[v] + up[v].size();
+        downOffsets[v + 1] = downOffsets[v] + down[v].size();
+    }
+    for (int v = 0; v < n; v++) {
+        for (auto &a : up[v]) {
+            upTargets.push_back(a.other);
+            upWeights.push_back(a.weight);
+            upMiddle.push_back(a.middle);
+        }
+        for (auto &a : down[v]) {
+            downSources.push_back(a.other);
+            downWeights.push_back(a.weight);
+            downMiddle.push_back(a.middle);
+        }
+    }
+}
+
+int ContractionHierarchy::getRank(int v) const {
+    return rank[v];
+}
+
+int ContractionHierarchy::getNumShortcuts() const {
+    return numShortcuts;
+}
+
+int ContractionHierarchy::findUpArc(int from, int to) const {
+    for (int a = upOffsets[from]; a < upOffsets[from + 1]; a++)
+        if (upTargets[a] == to) return a;
+    return -1;
+}
+
+int ContractionHierarchy::findDownArc(int from, int to) const {
+    for (int a = downOffsets[to]; a < downOffsets[to + 1]; a++)
+        if (downSources[a] == from) return a;
+    return -1;
+}
+
+void ContractionHierarchy::unpack(int from, int to, int middle, vector<int> &path) const {
+    if (middle == -1) {
+        path.push_back(graph.getId(to));
+        return;
+    }
+    // middle was contracted before both endpoints, so from -> middle is one of its
+    // downward arcs and middle -> to one of its upward arcs
+    unpack(from, middle, downMiddle[findDownArc(from, middle)], path);
+    unpack(middle, to, upMiddle[findUpArc(middle, to)], path);
+}
+
+vector<int> ContractionHierarchy::findBestRoute(int source, int destination, double &totalTime,
+                                                SearchWorkspace &fws, SearchWorkspace &bws) const {
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    if (s == -1 || t == -1) return {};
+
+    fws.reset(graph.getNumVertex());
+    bws.reset(graph.getNumVertex());
+    DaryHeap<4> fq(fws), bq(bws);
+    fws.setDist(s, 0);
+    fq.insert(s);
+    bws.setDist(t, 0);
+    bq.insert(t);
+
+    double best = INF;
+    int meet = -1;
+    bool forwardDone = false, backwardDone = false;
+    while (!forwardDone || !backwardDone) {
+        if (!forwardDone) {
+            if (fq.empty()) forwardDone = true;
+            else {
+                int v = fq.extractMin();
+                double d = fws.getDist(v);
+                if (d >= best) forwardDone = true; // nothing cheaper can meet any more
+                else {
+                    if (d + bws.getDist(v) < best) { best = d + bws.getDist(v); meet = v; }
+                    for (int a = upOffsets[v]; a < upOffsets[v + 1]; a++) {
+                        int w = upTargets[a];
+                        auto oldDist = fws.getDist(w);
+                        if (d + upWeights[a] < oldDist) {
+                            fws.setDist(w, d + upWeights[a]);
+                            fws.setParent(w, v);
+                            if (oldDist == INF) fq.insert(w);
+                            else fq.decreaseKey(w);
+                        }
+                    }
+                }
+            }
+        }
+        if (!backwardDone) {
+            if (bq.empty()) backwardDone = true;
+            else {
+                int v = bq.extractMin();
+                double d = bws.getDist(v);
+                if (d >= best) backwardDone = true;
+                else {
+                    if (d + fws.getDist(v) < best) { best = d + fws.getDist(v); meet = v; }
+                    for (int a = downOffsets[v]; a < downOffsets[v + 1]; a++) {
+                        int w = downSources[a];
+                        auto oldDist = bws.getDist(w);
+                        if (d + downWeights[a] < oldDist) {
+                            bws.setDist(w, d + downWeights[a]);
+                            bws.setParent(w, v);
+                            if (oldDist == INF) bq.insert(w);
+                            else bq.decreaseKey(w);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    if (meet == -1) return {};
+
+    // Upward chain s -> meet, then downward chain meet -> t, unpacking every arc
+    vector<int> chain;
+    for (int v = meet; v != -1; v = fws.getParent(v)) chain.push_back(v);
+    reverse(chain.begin(), chain.end());
+
+    vector<int> path = {graph.getId(s)};
+    for (size_t i = 0; i + 1 < chain.size(); i++) {
+        unpack(chain[i], chain[i + 1], upMiddle[findUpArc(chain[i], chain[i + 1])], path);
+    }
+    for (int v = meet; bws.getParent(v) != -1; v = bws.getParent(v)) {
+        int next = bws.getParent(v);
+        unpack(v, next, downMiddle[findDownArc(v, next)], path);
+    }
+
+    totalTime = best;
+    return path;
+}
+
+void ContractionHierarchy::upwardSearch(int root, bool forward, SearchWorkspace &ws,
+                                        vector<pair<int, double>> &settled) const {
+    const vector<int> &offsets = forward ? upOffsets : downOffsets;
+    const vector<int> &heads = forward ? upTargets : downSources;
+    const vector<double> &weights = forward ? upWeights : downWeights;
+
+    ws.reset(graph.getNumVertex());
+    DaryHeap<4> q(ws);
+    ws.setDist(root, 0);
+    q.insert(root);
+    while (!q.empty()) {
+        int v = q.extractMin();
+        double d = ws.getDist(v);
+        settled.emplace_back(v, d);
+        for (int a = offsets[v]; a < offsets[v + 1]; a++) {
+            int w = heads[a];
+            auto oldDist = ws.getDist(w);
+            if (d + weights[a] < oldDist) {
+                ws.setDist(w, d + weights[a]);
+                if (oldDist == INF) q.insert(w);
+                else q.decreaseKey(w);
+            }
+        }
+    }
+}
+
+void ContractionHierarchy::distanceMatrix(const vector<int> &sources, const vector<int> &targets, double *times,
+                                          unsigned numThreads) const {
+    size_t numCols = targets.size();
+    fill(times, times + sources.size() * numCols, INF);
+    if (sources.empty() || targets.empty()) return;
+
+    ThreadPool pool(numThreads);
+    vector<SearchWorkspace> workspaces(pool.size());
+
+    // 1. Backward search spaces of the targets
+    vector<vector<pair<int, double>>> reached(numCols);
+    pool.parallelFor(numCols, [&](int j, unsigned worker) {
+        int t = graph.getIndex(targets[j]);
+        if (t != -1) upwardSearch(t, false, workspaces[worker], reached[j]);
+    });
+
+    // Buckets as one array grouped by vertex: (target column, time from the vertex to it)
+    int n = graph.getNumVertex();
+    vector<int> bucketOffsets(n + 1, 0);
+    for (auto &space : reached)
+        for (auto &[v, d] : space) bucketOffsets[v + 1]++;
+    for (int v = 0; v < n; v++) bucketOffsets[v + 1] += bucketOffsets[v];
+    vector<pair<int, double>> buckets(bucketOffsets[n]);
+    vector<int> cursor(bucketOffsets.begin(), bucketOffsets.end() - 1);
+    for (size_t j = 0; j < numCols; j++) {
+        for (auto &[v, d] : reached[j]) buckets[cursor[v]++] = {(int) j, d};
+        vector<pair<int, double>>().swap(reached[j]);
+    }
+
+    // 2. Forward search per source, relaxing its row through the buckets it meets
+    pool.parallelFor(sources.size(), [&](int i, unsigned worker) {
+        int s = graph.getIndex(sources[i]);
+        if (s == -1) return;
+        vector<pair<int, double>> space;
+        upwardSearch(s, true, workspaces[worker], space);
+
+        double *row = times + (size_t) i * numCols;
+        for (auto &[v, d] : space) {
+            for (int b = bucketOffsets[v]; b < bucketOffsets[v + 1]; b++) {
+                auto [j, rest] = buckets[b];
+                if (d + rest < row[j]) row[j] = d + rest;
+            }
+        }
+    });
+}
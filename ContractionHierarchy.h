@@ -0,0 +1,78 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include <vector>
+#include <utility>
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
+
+/**
+ * Contraction Hierarchies over the static driving weights of a CSR snapshot.
+ *
+ * Preprocessing contracts the vertices one level at a time. Each level is an independent set
+ * of the remaining vertices whose priority (edge difference + contracted neighbours) is a local
+ * minimum. The shortcuts of a level are computed in parallel, with bounded witness searches
+ * that never pass through vertices of the same level. A query is then a bidirectional
+ * Dijkstra that only climbs towards higher-ranked vertices, followed by recursive unpacking of
+ * the shortcuts on the best path.
+ *
+ * The hierarchy does not know about avoided nodes or segments: it answers plain driving queries only.
+ */
+class ContractionHierarchy {
+public:
+    /*
+     * Preprocesses graph using numThreads workers (0 = one per hardware thread).
+     * The snapshot must outlive the hierarchy.
+     */
+    explicit ContractionHierarchy(const CsrGraph &graph, unsigned numThreads = 0);
+
+    /*
+     * Fastest driving route between two CSV Ids, as findBestRoute: returns the full
+     * (unpacked) path, or an empty vector if there is none.
+     */
+    std::vector<int> findBestRoute(int source, int destination, double &totalTime,
+                                   SearchWorkspace &forwardWs = SearchWorkspace::forThread(0),
+                                   SearchWorkspace &backwardWs = SearchWorkspace::forThread(1)) const;
+
+    /*
+     * Many-to-many driving times between CSV Ids (bucket method). One backward upward search per
+     * target files (target, time) into a bucket at every vertex it settles; one forward upward
+     * search per source then only scans the buckets of the vertices it settles. Both phases run
+     * on numThreads workers (0 = one per hardware thread) and write straight into times, a
+     * row-major sources.size() x targets.size() array: times[i * targets.size() + j] is the time
+     * from sources[i] to targets[j], INF if there is no route or an id is unknown.
+     */
+    void distanceMatrix(const std::vector<int> &sources, const std::vector<int> &targets, double *times,
+                        unsigned numThreads = 0) const;
+
+    int getRank(int v) const;
+    int getNumShortcuts() const;
+
+protected:
+    const CsrGraph &graph;
+    std::vector<int> rank; // contraction order, higher = more important
+
+    // upward arcs v -> x with rank[x] > rank[v], used by the forward search
+    std::vector<int> upOffsets, upTargets, upMiddle;
+    std::vector<double> upWeights;
+    // downward arcs x -> v with rank[x] > rank[v], stored at v and used by the backward search
+    std::vector<int> downOffsets, downSources, downMiddle;
+    std::vector<double> downWeights;
+
+    int numShortcuts = 0;
+
+    /*
+     * Exhaustive Dijkstra from dense index root over the upward (forward) or downward (backward)
+     * arcs; appends every settled vertex and its time to settled.
+     */
+    void upwardSearch(int root, bool forward, SearchWorkspace &ws, std::vector<std::pair<int, double>> &settled) const;
+
+    int findUpArc(int from, int to) const;
+    int findDownArc(int from, int to) const;
+    /*
+     * Appends the vertices of arc from -> to (excluding from) to path, expanding shortcuts.
+     */
+    void unpack(int from, int to, int middle, std::vector<int> &path) const;
+};
+
+#endif // CONTRACTION_HIERARCHY_H
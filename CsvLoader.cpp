@@ -0,0 +1,412 @@
+#include "CsvLoader.h"
+#include "reader.h"
+#include "data_structures/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <string_view>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+ * Read-only mapping of a whole file; ok is false if it could not be opened.
+ */
+class MappedCsv {
+public:
+    explicit MappedCsv(const string &path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1) return;
+        struct stat info {};
+        if (fstat(fd, &info) == 0) {
+            size = info.st_size;
+            if (size == 0) {
+                ok = true;
+            } else {
+                void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    data = static_cast<const char *>(mapped);
+                    madvise(mapped, size, MADV_SEQUENTIAL);
+                    ok = true;
+                }
+            }
+        }
+        close(fd);
+    }
+    ~MappedCsv() {
+        if (data) munmap(const_cast<char *>(data), size);
+    }
+    MappedCsv(const MappedCsv &) = delete;
+    MappedCsv &operator=(const MappedCsv &) = delete;
+
+    const char *data = nullptr;
+    size_t size = 0;
+    bool ok = false;
+};
+
+/*
+ * Text of one chunk: whole lines, the last one possibly without its newline.
+ */
+struct CsvChunk {
+    const char *begin;
+    const char *end;
+};
+
+/*
+ * Skips the header line, then cuts the rest of the file into about numChunks chunks, each
+ * ending right after a newline.
+ */
+vector<CsvChunk> splitCsvChunks(const MappedCsv &file, size_t numChunks) {
+    const char *begin = file.data, *end = file.data + file.size;
+    const char *header = begin ? static_cast<const char *>(memchr(begin, '\n', file.size)) : nullptr;
+    begin = header ? header + 1 : end;
+
+    vector<CsvChunk> chunks;
+    size_t step = max<size_t>((end - begin) / max<size_t>(numChunks, 1), 1);
+    while (begin < end) {
+        const char *cut = end - begin > (ptrdiff_t) step ? begin + step : end;
+        if (cut < end) {
+            auto newline = static_cast<const char *>(memchr(cut, '\n', end - cut));
+            cut = newline ? newline + 1 : end;
+        }
+        chunks.push_back({begin, cut});
+        begin = cut;
+    }
+    return chunks;
+}
+
+/*
+ * Calls row(line) for every line of the chunk, without its line break. Stops and returns
+ * the 1-based number of the line where row returned false, or 0 if every line was accepted.
+ * lines is set to the number of lines seen.
+ */
+template <class Row>
+size_t forEachCsvLine(const CsvChunk &chunk, size_t &lines, Row row) {
+    lines = 0;
+    for (const char *p = chunk.begin; p < chunk.end; ) {
+        auto newline = static_cast<const char *>(memchr(p, '\n', chunk.end - p));
+        const char *lineEnd = newline ? newline : chunk.end;
+        string_view line(p, lineEnd - p);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        lines++;
+        if (!line.empty() && !row(line)) return lines;
+        p = lineEnd + 1;
+    }
+    return 0;
+}
+
+/*
+ * The first four comma-separated fields of line, like four getline(ss, field, ',') calls:
+ * missing fields are empty and anything after a fourth comma is ignored.
+ */
+void splitCsvFields(string_view line, string_view (&fields)[4]) {
+    for (auto &field : fields) {
+        size_t comma = line.find(',');
+        field = line.substr(0, comma);
+        line = comma == string_view::npos ? string_view() : line.substr(comma + 1);
+    }
+}
+
+/*
+ * Number at the start of text after optional blanks and '+', as accepted by stoi / stod
+ * (trailing characters are ignored). Returns false if there is none or it overflows.
+ */
+template <class Number>
+bool parseCsvNumber(string_view text, Number &value) {
+    size_t i = 0;
+    while (i < text.size() && (text[i] == ' ' || text[i] == '\t')) i++;
+    if (i < text.size() && text[i] == '+') i++;
+    auto [ptr, ec] = from_chars(text.data() + i, text.data() + text.size(), value);
+    return ec == errc();
+}
+
+/*
+ * Open-addressing map from views of the mapped text to ints, sized up front for capacity keys.
+ * Distances.csv costs two code lookups per row, and a flat probe with the hash kept next to the
+ * key touches far fewer cache lines than unordered_map's buckets and nodes. find() only reads,
+ * so any number of threads may look up at once.
+ */
+class CsvStringMap {
+public:
+    explicit CsvStringMap(size_t capacity) {
+        size_t size = 16;
+        while (size < 2 * capacity) size *= 2;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    /*
+     * The value of key, after inserting it with value if it was missing (inserted tells which).
+     */
+    int &insert(string_view key, int value, bool &inserted) {
+        size_t hash = std::hash<string_view>()(key);
+        for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+            Slot &slot = slots[i];
+            if (slot.size == -1) {
+                slot = {hash, key.data(), (int) key.size(), value};
+                inserted = true;
+                return slot.value;
+            }
+            if (slot.hash == hash && string_view(slot.data, slot.size) == key) {
+                inserted = false;
+                return slot.value;
+            }
+        }
+    }
+
+    int find(string_view key, int missing) const {
+        size_t hash = std::hash<string_view>()(key);
+        for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+            const Slot &slot = slots[i];
+            if (slot.size == -1) return missing;
+            if (slot.hash == hash && string_view(slot.data, slot.size) == key) return slot.value;
+        }
+    }
+
+private:
+    struct Slot {
+        size_t hash = 0;
+        const char *data = nullptr;
+        int size = -1;   // -1 marks an empty slot
+        int value = 0;
+    };
+    vector<Slot> slots;
+    size_t mask;
+};
+
+struct LocationRow {
+    int id;
+    int parking;
+    string_view location;
+    string_view code;
+};
+
+struct DistanceRow {
+    int from;   // dense indices
+    int to;
+    double driving;
+    double walking;
+};
+
+/*
+ * Parses every chunk on the pool into rows[chunk]; parse(line, rows) returns false on a bad
+ * line. Returns false after reporting the first bad line of the file.
+ */
+template <class Row, class Parse>
+bool parseCsvChunks(ThreadPool &pool, const string &path, const vector<CsvChunk> &chunks,
+                    vector<vector<Row>> &rows, Parse parse) {
+    rows.assign(chunks.size(), {});
+    vector<size_t> lines(chunks.size()), badLine(chunks.size());
+    pool.parallelFor(chunks.size(), [&](int c, unsigned) {
+        badLine[c] = forEachCsvLine(chunks[c], lines[c], [&](string_view line) { return parse(line, rows[c]); });
+    });
+
+    size_t before = 1; // header
+    for (size_t c = 0; c < chunks.size(); c++) {
+        if (badLine[c]) {
+            cerr << "Error parsing " << path << " line " << before + badLine[c] << endl;
+            return false;
+        }
+        before += lines[c];
+    }
+    return true;
+}
+
+unique_ptr<CsrGraph> loadCsvGraph(const string &locationsPath, const string &distancesPath, unsigned numThreads) {
+    MappedCsv locationsFile(locationsPath), distancesFile(distancesPath);
+    for (auto [file, path] : {pair(&locationsFile, &locationsPath), pair(&distancesFile, &distancesPath)}) {
+        if (!file->ok) {
+            cerr << "Error opening file: " << *path << endl;
+            return nullptr;
+        }
+    }
+    ThreadPool pool(numThreads);
+    size_t numChunks = 4 * pool.size();
+
+    // 1. Locations: parsed in parallel, then merged in file order
+    vector<vector<LocationRow>> locationRows;
+    bool parsed = parseCsvChunks(pool, locationsPath, splitCsvChunks(locationsFile, numChunks), locationRows,
+                                 [](string_view line, vector<LocationRow> &rows) {
+        string_view fields[4];
+        splitCsvFields(line, fields);
+        LocationRow row{0, 0, fields[0], fields[2]};
+        if (!parseCsvNumber(fields[1], row.id) || !parseCsvNumber(fields[3], row.parking)) return false;
+        rows.push_back(row);
+        return true;
+    });
+    if (!parsed) return nullptr;
+
+    // A repeated Id keeps its first position but takes the later attributes, as in Reader.
+    // Codes map straight to dense indices: an Id's index never changes once it is added.
+    size_t numRows = 0;
+    for (auto &chunkRows : locationRows) numRows += chunkRows.size();
+    unique_ptr<CsrGraph> graph(new CsrGraph());
+    auto &owned = graph->owned;
+    unordered_map<int, int> idToIndex;
+    idToIndex.reserve(numRows);
+    CsvStringMap codeToIndex(numRows);
+    vector<int> parkingValues;
+    vector<string_view> locations, codes;
+    bool inserted;
+    for (auto &chunkRows : locationRows) {
+        for (auto &row : chunkRows) {
+            auto [it, newId] = idToIndex.emplace(row.id, (int) owned.ids.size());
+            if (newId) {
+                owned.ids.push_back(row.id);
+                parkingValues.push_back(row.parking);
+                locations.push_back(row.location);
+                codes.push_back(row.code);
+            } else {
+                parkingValues[it->second] = row.parking;
+                locations[it->second] = row.location;
+                codes[it->second] = row.code;
+            }
+            codeToIndex.insert(row.code, it->second, inserted) = it->second;
+        }
+    }
+    int n = owned.ids.size();
+
+    // Unknown codes resolve to Id -1, like Graph::getIdFromCode
+    auto missing = idToIndex.find(-1);
+    int unknownCodeIndex = missing == idToIndex.end() ? -1 : missing->second;
+
+    owned.parking.resize(n);
+    owned.locationNames.resize(n);
+    owned.codeNames.resize(n);
+    owned.stringOffsets.push_back(0);
+    CsvStringMap interned(2 * n);
+    auto intern = [&](string_view text) {
+        int &number = interned.insert(text, owned.stringOffsets.size() - 1, inserted);
+        if (inserted) {
+            owned.stringData.insert(owned.stringData.end(), text.begin(), text.end());
+            owned.stringOffsets.push_back(owned.stringData.size());
+        }
+        return number;
+    };
+    for (int v = 0; v < n; v++) {
+        owned.parking[v] = parkingValues[v] == 1;
+        if (owned.parking[v]) owned.parkingVertices.push_back(v);
+        owned.locationNames[v] = intern(locations[v]);
+        owned.codeNames[v] = intern(codes[v]);
+    }
+
+    // 2. Distances: parsed in parallel, codes resolved against the finished lookup table
+    vector<vector<DistanceRow>> distanceRows;
+    parsed = parseCsvChunks(pool, distancesPath, splitCsvChunks(distancesFile, numChunks), distanceRows,
+                            [&](string_view line, vector<DistanceRow> &rows) {
+        string_view fields[4];
+        splitCsvFields(line, fields);
+        DistanceRow row{-1, -1, INF, 0};
+        if (fields[2] != "X" && !parseCsvNumber(fields[2], row.driving)) return false;
+        if (!parseCsvNumber(fields[3], row.walking)) return false;
+        row.from = codeToIndex.find(fields[0], unknownCodeIndex);
+        row.to = codeToIndex.find(fields[1], unknownCodeIndex);
+        if (row.from != -1 && row.to != -1) rows.push_back(row); // addBidirectionalEdge skips these
+        return true;
+    });
+    if (!parsed) return nullptr;
+
+    // 3. Counting sort of both directions of every row on their origin, in parallel
+    size_t numRowChunks = distanceRows.size();
+    vector<size_t> firstRow(numRowChunks + 1, 0);
+    for (size_t c = 0; c < numRowChunks; c++) firstRow[c + 1] = firstRow[c] + distanceRows[c].size();
+    int m = 2 * firstRow[numRowChunks];
+
+    owned.offsets.assign(n + 1, 0);
+    pool.parallelFor(numRowChunks, [&](int c, unsigned) {
+        for (auto &row : distanceRows[c]) {
+            atomic_ref(owned.offsets[row.from + 1]).fetch_add(1, memory_order_relaxed);
+            atomic_ref(owned.offsets[row.to + 1]).fetch_add(1, memory_order_relaxed);
+        }
+    });
+    for (int v = 0; v < n; v++) owned.offsets[v + 1] += owned.offsets[v];
+
+    // Slots are claimed in any order; the rank (2 * row, +1 for the reverse edge) restores file
+    // order. Each slot is one record, so claiming it costs a single scattered write.
+    struct RankedEdge {
+        long long rank;
+        int target;
+        float driving;
+        float walking;
+    };
+    vector<int> cursor(owned.offsets.begin(), owned.offsets.end() - 1);
+    vector<RankedEdge> edges(m);
+    pool.parallelFor(numRowChunks, [&](int c, unsigned) {
+        long long r = firstRow[c];
+        for (auto &row : distanceRows[c]) {
+            int e = atomic_ref(cursor[row.from]).fetch_add(1, memory_order_relaxed);
+            float driving = CsrGraph::packWeight(row.driving), walking = CsrGraph::packWeight(row.walking);
+            edges[e] = {2 * r, row.to, driving, walking};
+            e = atomic_ref(cursor[row.to]).fetch_add(1, memory_order_relaxed);
+            edges[e] = {2 * r + 1, row.from, driving, walking};
+            r++;
+        }
+    });
+    vector<vector<DistanceRow>>().swap(distanceRows);
+
+    owned.targets.resize(m);
+    owned.drivingWeights.resize(m);
+    owned.walkingWeights.resize(m);
+    const int blockSize = 4096;
+    pool.parallelFor((n + blockSize - 1) / blockSize, [&](int block, unsigned) {
+        int last = min(n, (block + 1) * blockSize);
+        for (int v = block * blockSize; v < last; v++) {
+            // Insertion sort: adjacency lists are short and usually close to sorted already
+            for (int e = owned.offsets[v] + 1; e < owned.offsets[v + 1]; e++) {
+                RankedEdge edge = edges[e];
+                int k = e;
+                for (; k > owned.offsets[v] && edges[k - 1].rank > edge.rank; k--) edges[k] = edges[k - 1];
+                edges[k] = edge;
+            }
+            for (int e = owned.offsets[v]; e < owned.offsets[v + 1]; e++) {
+                owned.targets[e] = edges[e].target;
+                owned.drivingWeights[e] = edges[e].driving;
+                owned.walkingWeights[e] = edges[e].walking;
+            }
+        }
+    });
+
+    graph->finishOwnedArrays();
+    return graph;
+}
+
+void runCsvLoadBenchmark(const string &locationsPath, const string &distancesPath, ostream &out, int rounds) {
+    error_code ec;
+    double megabytes = (filesystem::file_size(locationsPath, ec) + filesystem::file_size(distancesPath, ec)) / 1e6;
+    auto report = [&](const string &name, double ms, int numEdges) {
+        out << left << setw(30) << name << right << fixed << setprecision(2) << setw(10) << ms << " ms"
+            << setw(12) << megabytes / (ms / 1000) << " MB/s  (" << numEdges << " edges)\n";
+    };
+
+    out << "Loading " << megabytes << " MB of CSV, best of " << rounds << " rounds\n";
+    double readerMs = INF, loaderMs = INF;
+    int readerEdges = 0, loaderEdges = 0;
+    for (int round = 0; round < rounds; round++) {
+        auto start = chrono::steady_clock::now();
+        {
+            Reader<int> reader;
+            Graph<int> graph;
+            reader.loadLocations(graph, locationsPath);
+            reader.loadDistances(graph, distancesPath);
+            CsrGraph csr(graph);
+            readerEdges = csr.getNumEdges();
+        }
+        auto middle = chrono::steady_clock::now();
+        auto csr = loadCsvGraph(locationsPath, distancesPath);
+        auto end = chrono::steady_clock::now();
+        if (!csr) return;
+        loaderEdges = csr->getNumEdges();
+        readerMs = min(readerMs, chrono::duration<double, milli>(middle - start).count());
+        loaderMs = min(loaderMs, chrono::duration<double, milli>(end - middle).count());
+    }
+    report("Reader + CsrGraph", readerMs, readerEdges);
+    report("loadCsvGraph", loaderMs, loaderEdges);
+}
@@ -0,0 +1,31 @@
+#ifndef CSV_LOADER_H
+#define CSV_LOADER_H
+
+#include <string>
+#include <memory>
+#include <iostream>
+#include "data_structures/CsrGraph.h"
+
+/**
+ * Builds the CSR snapshot straight from Locations.csv and Distances.csv, with the same
+ * result as Reader<int> followed by CsrGraph(graph) (vertex order, edge order, "X" for a
+ * non-drivable segment, rows with unknown codes skipped, later rows winning for repeated
+ * Ids and codes), but without a Graph<int> in between.
+ *
+ * Both files are mapped into memory and split into chunks on line boundaries. The chunks are
+ * parsed on numThreads workers (0 = one per hardware thread) with std::from_chars on views of
+ * the mapped text, and the adjacency is laid out by a parallel counting sort on the edge
+ * origins. Returns nullptr, after printing the file and line to std::cerr, if a file cannot be
+ * read or a number does not parse.
+ */
+std::unique_ptr<CsrGraph> loadCsvGraph(const std::string &locationsPath, const std::string &distancesPath,
+                                       unsigned numThreads = 0);
+
+/**
+ * Loads both files rounds times with Reader<int> + CsrGraph and with loadCsvGraph and writes
+ * the best time and throughput (MB/s of CSV text) of each to out.
+ */
+void runCsvLoadBenchmark(const std::string &locationsPath, const std::string &distancesPath,
+                         std::ostream &out, int rounds = 5);
+
+#endif // CSV_LOADER_H
@@ -0,0 +1,85 @@
+#include "DistanceMatrix.h"
+#include "data_structures/SearchQueue.h"
+#include "data_structures/ThreadPool.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+
+using namespace std;
+
+void distanceMatrix(const CsrGraph &graph, const vector<int> &sources, const vector<int> &targets,
+                    double *times, unsigned numThreads) {
+    size_t numCols = targets.size();
+    fill(times, times + sources.size() * numCols, INF);
+    if (sources.empty() || targets.empty()) return;
+
+    vector<int> targetIndex(numCols);
+    for (size_t j = 0; j < numCols; j++) targetIndex[j] = graph.getIndex(targets[j]);
+    vector<int> pending;
+    for (int t : targetIndex) if (t != -1) pending.push_back(t);
+    sort(pending.begin(), pending.end());
+    pending.erase(unique(pending.begin(), pending.end()), pending.end());
+
+    ThreadPool pool(numThreads);
+    vector<SearchWorkspace> workspaces(pool.size());
+    pool.parallelFor(sources.size(), [&](int i, unsigned worker) {
+        int s = graph.getIndex(sources[i]);
+        if (s == -1) return;
+
+        SearchWorkspace &ws = workspaces[worker];
+        size_t unsettled = pending.size();
+        ws.reset(graph.getNumVertex());
+        ws.setDist(s, 0);
+        withSearchQueue(graph, [&](auto makeQueue) {
+            auto q = makeQueue(ws);
+            q.insert(s);
+            while (!q.empty() && unsettled > 0) {
+                int v = q.extractMin();
+                double d = ws.getDist(v);
+                if (binary_search(pending.begin(), pending.end(), v)) unsettled--;
+
+                for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+                    int w = graph.getTarget(e);
+                    double weight = graph.getDrivingWeight(e);
+                    if (weight == INF) continue;
+
+                    auto oldDist = ws.getDist(w);
+                    if (d + weight < oldDist) {
+                        ws.setDist(w, d + weight);
+                        if (oldDist == INF) q.insert(w);
+                        else q.decreaseKey(w);
+                    }
+                }
+            }
+        });
+
+        // Targets still queued when the search stopped are unreachable or already final
+        double *row = times + (size_t) i * numCols;
+        for (size_t j = 0; j < numCols; j++) {
+            if (targetIndex[j] != -1) row[j] = ws.getDist(targetIndex[j]);
+        }
+    });
+}
+
+void writeMatrixCsv(ostream &out, const vector<int> &sources, const vector<int> &targets, const double *times) {
+    for (int t : targets) out << "," << t;
+    out << "\n";
+    for (size_t i = 0; i < sources.size(); i++) {
+        out << sources[i];
+        for (size_t j = 0; j < targets.size(); j++) {
+            out << ",";
+            double time = times[i * targets.size() + j];
+            if (time != INF) out << time;
+        }
+        out << "\n";
+    }
+}
+
+bool writeMatrixBinary(const string &path, size_t numRows, size_t numCols, const double *times) {
+    ofstream file(path, ios::binary);
+    if (!file) return false;
+    uint32_t header[2] = {(uint32_t) numRows, (uint32_t) numCols};
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(times), numRows * numCols * sizeof(double));
+    return (bool) file;
+}
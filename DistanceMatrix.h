@@ -0,0 +1,30 @@
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include "data_structures/CsrGraph.h"
+
+/**
+ * Same matrix as ContractionHierarchy::distanceMatrix without preprocessing: one driving
+ * Dijkstra per source (stopped once every target is settled), spread over numThreads workers.
+ */
+void distanceMatrix(const CsrGraph &graph, const std::vector<int> &sources, const std::vector<int> &targets,
+                    double *times, unsigned numThreads = 0);
+
+/**
+ * CSV form of a row-major matrix: a header line with the target Ids, then one line per source
+ * starting with its Id. Unreachable pairs are left empty.
+ */
+void writeMatrixCsv(std::ostream &out, const std::vector<int> &sources, const std::vector<int> &targets,
+                    const double *times);
+
+/**
+ * Binary form: the rows and columns as two uint32 values, then the times as rows * cols native
+ * doubles in row-major order (unreachable pairs hold the largest double). Returns false if the
+ * file cannot be written.
+ */
+bool writeMatrixBinary(const std::string &path, size_t numRows, size_t numCols, const double *times);
+
+#endif // DISTANCE_MATRIX_H
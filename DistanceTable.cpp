@@ -0,0 +1,238 @@
+#include "DistanceTable.h"
+#include "data_structures/SearchQueue.h"
+#include "data_structures/ThreadPool.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+const char tableMagic[8] = {'D', 'A', 'T', 'A', 'B', 'L', 'E', '1'};
+
+struct TableHeader {
+    char magic[8];
+    uint32_t numVertex;
+    uint32_t numEdges;
+    uint64_t fingerprint;   // graphFingerprint of the snapshot the tables were built from
+};
+
+/*
+ * FNV-1a over the Ids, edges, weights and parking flags, so a table is never read against a
+ * snapshot of different data.
+ */
+uint64_t graphFingerprint(const CsrGraph &graph) {
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&](const void *data, size_t size) {
+        auto bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    };
+    for (int v = 0; v < graph.getNumVertex(); v++) {
+        int id = graph.getId(v), parking = graph.getParking(v);
+        mix(&id, sizeof(id));
+        mix(&parking, sizeof(parking));
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+            int w = graph.getTarget(e);
+            double drive = graph.getDrivingWeight(e), walk = graph.getWalkingWeight(e);
+            mix(&w, sizeof(w));
+            mix(&drive, sizeof(drive));
+            mix(&walk, sizeof(walk));
+        }
+    }
+    return hash;
+}
+
+/*
+ * One-to-all Dijkstra from root over outgoing edges; copies the times and parents of every
+ * vertex into the table rows.
+ */
+void fillTableRow(const CsrGraph &graph, int root, bool useDriving, SearchWorkspace &ws,
+                  double *times, int *parents) {
+    ws.reset(graph.getNumVertex());
+    ws.setDist(root, 0);
+    withSearchQueue(graph, [&](auto makeQueue) {
+        auto q = makeQueue(ws);
+        q.insert(root);
+
+        while (!q.empty()) {
+            int v = q.extractMin();
+            double d = ws.getDist(v);
+            for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+                int w = graph.getTarget(e);
+                double weight = useDriving ? graph.getDrivingWeight(e) : graph.getWalkingWeight(e);
+                if (weight == INF) continue;
+
+                auto oldDist = ws.getDist(w);
+                if (d + weight < oldDist) {
+                    ws.setDist(w, d + weight);
+                    ws.setParent(w, v);
+                    if (oldDist == INF) q.insert(w);
+                    else q.decreaseKey(w);
+                }
+            }
+        }
+    });
+
+    for (int v = 0; v < graph.getNumVertex(); v++) {
+        times[v] = ws.getDist(v);
+        parents[v] = ws.getParent(v);
+    }
+}
+
+DistanceTable::DistanceTable(const CsrGraph &graph) : graph(graph), n(graph.getNumVertex()) {}
+
+unique_ptr<DistanceTable> DistanceTable::build(const CsrGraph &graph, unsigned numThreads) {
+    unique_ptr<DistanceTable> table(new DistanceTable(graph));
+    size_t cells = (size_t) table->n * table->n;
+    table->ownedTimes.resize(2 * cells);
+    table->ownedParents.resize(2 * cells);
+    table->drivingTimes = table->ownedTimes.data();
+    table->walkingTimes = table->ownedTimes.data() + cells;
+    table->drivingParents = table->ownedParents.data();
+    table->walkingParents = table->ownedParents.data() + cells;
+
+    // Task 2s fills the driving row of s, task 2s + 1 its walking row
+    ThreadPool pool(numThreads);
+    vector<SearchWorkspace> workspaces(pool.size());
+    pool.parallelFor(2 * table->n, [&](int task, unsigned worker) {
+        size_t row = (size_t) (task / 2) * table->n + (task % 2 ? cells : 0);
+        fillTableRow(graph, task / 2, task % 2 == 0, workspaces[worker],
+                     table->ownedTimes.data() + row, table->ownedParents.data() + row);
+    });
+    return table;
+}
+
+unique_ptr<DistanceTable> DistanceTable::load(const CsrGraph &graph, const string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) return nullptr;
+
+    struct stat info {};
+    size_t cells = (size_t) graph.getNumVertex() * graph.getNumVertex();
+    size_t expected = sizeof(TableHeader) + 2 * cells * (sizeof(double) + sizeof(int));
+    void *mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t) info.st_size == expected) {
+        mapping = mmap(nullptr, expected, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd); // the mapping keeps the file open
+    if (mapping == MAP_FAILED) return nullptr;
+
+    auto header = static_cast<const TableHeader *>(mapping);
+    if (memcmp(header->magic, tableMagic, sizeof(tableMagic)) != 0
+        || header->numVertex != (uint32_t) graph.getNumVertex()
+        || header->numEdges != (uint32_t) graph.getNumEdges()
+        || header->fingerprint != graphFingerprint(graph)) {
+        munmap(mapping, expected);
+        return nullptr;
+    }
+
+    unique_ptr<DistanceTable> table(new DistanceTable(graph));
+    table->mapping = mapping;
+    table->mappingSize = expected;
+    auto times = reinterpret_cast<const double *>(static_cast<const char *>(mapping) + sizeof(TableHeader));
+    auto parents = reinterpret_cast<const int *>(times + 2 * cells);
+    table->drivingTimes = times;
+    table->walkingTimes = times + cells;
+    table->drivingParents = parents;
+    table->walkingParents = parents + cells;
+    return table;
+}
+
+DistanceTable::~DistanceTable() {
+    if (mapping) munmap(mapping, mappingSize);
+}
+
+bool DistanceTable::save(const string &path) const {
+    ofstream file(path, ios::binary);
+    if (!file) return false;
+
+    // Times first, so both double tables stay 8-byte aligned behind the 24-byte header
+    size_t cells = (size_t) n * n;
+    TableHeader header{};
+    memcpy(header.magic, tableMagic, sizeof(tableMagic));
+    header.numVertex = n;
+    header.numEdges = graph.getNumEdges();
+    header.fingerprint = graphFingerprint(graph);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(drivingTimes), cells * sizeof(double));
+    file.write(reinterpret_cast<const char *>(walkingTimes), cells * sizeof(double));
+    file.write(reinterpret_cast<const char *>(drivingParents), cells * sizeof(int));
+    file.write(reinterpret_cast<const char *>(walkingParents), cells * sizeof(int));
+    return (bool) file;
+}
+
+double DistanceTable::drivingTime(int source, int destination) const {
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    return s == -1 || t == -1 ? INF : drivingTimes[(size_t) s * n + t];
+}
+
+double DistanceTable::walkingTime(int source, int destination) const {
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    return s == -1 || t == -1 ? INF : walkingTimes[(size_t) s * n + t];
+}
+
+void DistanceTable::appendPath(const int *parents, int s, int t, vector<int> &path) const {
+    size_t first = path.size();
+    const int *row = parents + (size_t) s * n;
+    for (int v = t; v != -1; v = row[v]) path.push_back(graph.getId(v));
+    reverse(path.begin() + first, path.end());
+}
+
+vector<int> DistanceTable::findBestRoute(int source, int destination, double &totalTime) const {
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    if (s == -1 || t == -1) return {};
+
+    double time = drivingTimes[(size_t) s * n + t];
+    if (time == INF) return {}; // Return empty vector if no path exists
+
+    vector<int> path;
+    appendPath(drivingParents, s, t, path);
+    totalTime = time;
+    return path;
+}
+
+EnvFriendlyRoute DistanceTable::findEnvFriendlyRoute(int source, int destination, double maxWalkTime) const {
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+
+    // Same candidates as the search versions: parking nodes other than the two ends
+    vector<ParkingOption> options;
+    bool anyParking = false;
+    if (s != -1) {
+        const double *drive = drivingTimes + (size_t) s * n;
+        const double *walk = t == -1 ? nullptr : walkingTimes + (size_t) t * n;
+        for (int v : graph.getParkingVertices()) {
+            if (v == s || drive[v] == INF) continue;
+            anyParking = true;
+            if (v == t || !walk || walk[v] == INF || walk[v] > maxWalkTime) continue;
+            options.push_back({v, drive[v], walk[v], drive[v] + walk[v]});
+        }
+    }
+    if (options.empty()) return EnvFriendlyRoute{-1, 0, 0, 0, {}, {}, envFailureMessage(anyParking)};
+
+    sortParkingOptions(options);
+    auto makeRoute = [&](const ParkingOption &option) {
+        EnvFriendlyRoute route{graph.getId(option.node), option.drivingTime, option.walkingTime, option.totalTime};
+        appendPath(drivingParents, s, option.node, route.drivingPath);
+        appendPath(walkingParents, t, option.node, route.walkingPath);
+        reverse(route.walkingPath.begin(), route.walkingPath.end()); // walked from the parking node
+        return route;
+    };
+    EnvFriendlyRoute best = makeRoute(options[0]);
+    if (options.size() > 1) best.alternatives.push_back(makeRoute(options[1]));
+    return best;
+}
+
+bool DistanceTable::isMapped() const {
+    return mapping != nullptr;
+}
+
+size_t DistanceTable::getSizeBytes() const {
+    return 2 * (size_t) n * n * (sizeof(double) + sizeof(int));
+}
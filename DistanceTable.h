@@ -0,0 +1,82 @@
+#ifndef DISTANCE_TABLE_H
+#define DISTANCE_TABLE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstddef>
+#include "data_structures/CsrGraph.h"
+#include "EnvFriendlyRoute.h"
+
+/**
+ * All-pairs driving and walking times over a CSR snapshot, for graphs small enough that
+ * n x n tables fit in memory (about 24 bytes per vertex pair).
+ *
+ * Row s of each table is the shortest-path tree of a Dijkstra from s: the time to every
+ * vertex and its parent, from which paths are rebuilt without searching. Tables can be
+ * saved to a file and later mapped back read-only with mmap, so a restarted process answers
+ * plain driving and env queries with lookups only. Avoid lists change the distances, so
+ * restricted queries still need a graph search.
+ */
+class DistanceTable {
+public:
+    /*
+     * Runs one driving and one walking Dijkstra per vertex on numThreads workers
+     * (0 = one per hardware thread). The snapshot must outlive the table.
+     */
+    static std::unique_ptr<DistanceTable> build(const CsrGraph &graph, unsigned numThreads = 0);
+
+    /*
+     * Maps a file written by save(). Returns nullptr if it cannot be opened or was built
+     * from a different graph.
+     */
+    static std::unique_ptr<DistanceTable> load(const CsrGraph &graph, const std::string &path);
+
+    ~DistanceTable();
+    DistanceTable(const DistanceTable &) = delete;
+    DistanceTable &operator=(const DistanceTable &) = delete;
+
+    /*
+     * Returns false if the file cannot be written.
+     */
+    bool save(const std::string &path) const;
+
+    /*
+     * Times between CSV Ids, INF if there is no route or an id is unknown.
+     */
+    double drivingTime(int source, int destination) const;
+    double walkingTime(int source, int destination) const;
+
+    /*
+     * Same contracts as the CsrGraph findBestRoute and findEnvFriendlyRoute without avoid lists.
+     */
+    std::vector<int> findBestRoute(int source, int destination, double &totalTime) const;
+    EnvFriendlyRoute findEnvFriendlyRoute(int source, int destination, double maxWalkTime) const;
+
+    bool isMapped() const;
+    size_t getSizeBytes() const;
+
+protected:
+    const CsrGraph &graph;
+    int n;
+
+    // Row-major n x n: entry s * n + v holds the time from s to v / the parent of v in the tree of s
+    const double *drivingTimes = nullptr;
+    const double *walkingTimes = nullptr;
+    const int *drivingParents = nullptr;
+    const int *walkingParents = nullptr;
+
+    std::vector<double> ownedTimes;   // tables built in this process
+    std::vector<int> ownedParents;
+    void *mapping = nullptr;          // tables mapped from a file
+    size_t mappingSize = 0;
+
+    explicit DistanceTable(const CsrGraph &graph);
+
+    /*
+     * Appends the path from dense index s to t (CSV Ids) read from the given parents table.
+     */
+    void appendPath(const int *parents, int s, int t, std::vector<int> &path) const;
+};
+
+#endif // DISTANCE_TABLE_H
@@ -0,0 +1,134 @@
+#include "DrivingAlternatives.h"
+#include "data_structures/SearchQueue.h"
+#include <algorithm>
+#include <unordered_set>
+
+using namespace std;
+
+/*
+ * Driving Dijkstra from root, over incoming edges if backward, that stops once every vertex
+ * within (1 + maxStretch) times the distance to target is settled. Returns that distance, or
+ * INF (after settling everything reachable) if target cannot be reached.
+ */
+double stretchBoundedTree(const CsrGraph &graph, int root, int target, bool backward, double maxStretch,
+                          SearchWorkspace &ws) {
+    ws.reset(graph.getNumVertex());
+    ws.setDist(root, 0);
+    double targetDist = INF;
+    withSearchQueue(graph, [&](auto makeQueue) {
+        auto q = makeQueue(ws);
+        q.insert(root);
+
+        while (!q.empty()) {
+            int v = q.extractMin();
+            double d = ws.getDist(v);
+            if (d > (1 + maxStretch) * targetDist) break;
+            if (v == target) targetDist = d;
+
+            int begin = backward ? graph.inEdgeBegin(v) : graph.edgeBegin(v);
+            int end = backward ? graph.inEdgeEnd(v) : graph.edgeEnd(v);
+            for (int k = begin; k < end; k++) {
+                int w = backward ? graph.getInSource(k) : graph.getTarget(k);
+                double weight = graph.getDrivingWeight(backward ? graph.getInEdge(k) : k);
+                if (weight == INF) continue;
+
+                auto oldDist = ws.getDist(w);
+                if (d + weight < oldDist) {
+                    ws.setDist(w, d + weight);
+                    ws.setParent(w, v);
+                    if (oldDist == INF) q.insert(w);
+                    else q.decreaseKey(w);
+                }
+            }
+        }
+    });
+    return targetDist;
+}
+
+vector<DrivingAlternative> findDrivingAlternatives(const CsrGraph &graph, int source, int destination, int k,
+                                                   const AlternativeLimits &limits,
+                                                   SearchWorkspace &forwardWs, SearchWorkspace &backwardWs) {
+    vector<DrivingAlternative> routes;
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    if (s == -1 || t == -1 || s == t) return routes;
+
+    double best = stretchBoundedTree(graph, s, t, false, limits.maxStretch, forwardWs);
+    if (best == INF) return routes;
+    stretchBoundedTree(graph, t, s, true, limits.maxStretch, backwardWs);
+    double maxTime = (1 + limits.maxStretch) * best;
+
+    // Both trees are final for every vertex whose via route fits the stretch limit
+    auto viaTime = [&](int v) { return forwardWs.getDist(v) + backwardWs.getDist(v); };
+    auto onBothTrees = [&](int u, int v) {
+        return u != -1 && v != -1 && forwardWs.getParent(v) == u && backwardWs.getParent(u) == v;
+    };
+
+    struct Plateau {
+        int first;
+        double time;     // time of the route through it
+        double length;   // driving time along the plateau itself
+    };
+    vector<Plateau> plateaus;
+    for (int v = 0; v < graph.getNumVertex(); v++) {
+        if (viaTime(v) > maxTime || onBothTrees(forwardWs.getParent(v), v)) continue; // not the first node
+        int last = v;
+        while (onBothTrees(last, backwardWs.getParent(last))) last = backwardWs.getParent(last);
+        plateaus.push_back({v, viaTime(v), forwardWs.getDist(last) - forwardWs.getDist(v)});
+    }
+    sort(plateaus.begin(), plateaus.end(), [](const Plateau &a, const Plateau &b) {
+        if (a.time != b.time) return a.time < b.time;
+        if (a.length != b.length) return a.length > b.length;
+        return a.first < b.first;
+    });
+
+    // Segments (dense u, v) of the routes kept so far
+    unordered_set<long long> usedSegments;
+    auto segmentKey = [&](int u, int v) { return (long long) u * graph.getNumVertex() + v; };
+
+    // Route through a vertex as dense indices, with the driving time at each of them
+    auto viaRoute = [&](int via, vector<int> &path, vector<double> &at) {
+        for (int v = via; v != -1; v = forwardWs.getParent(v)) path.push_back(v);
+        reverse(path.begin(), path.end());
+        for (int v : path) at.push_back(forwardWs.getDist(v));
+        for (int v = backwardWs.getParent(via); v != -1; v = backwardWs.getParent(v)) {
+            path.push_back(v);
+            at.push_back(viaTime(via) - backwardWs.getDist(v));
+        }
+    };
+    auto keep = [&](const vector<int> &path, double time, int via, double shared) {
+        DrivingAlternative route{{}, time, via == -1 ? -1 : graph.getId(via), shared};
+        for (size_t i = 0; i < path.size(); i++) {
+            route.path.push_back(graph.getId(path[i]));
+            if (i + 1 < path.size()) usedSegments.insert(segmentKey(path[i], path[i + 1]));
+        }
+        routes.push_back(std::move(route));
+    };
+
+    vector<int> path;
+    vector<double> at;
+    viaRoute(t, path, at);
+    keep(path, best, -1, 0);
+
+    for (const Plateau &plateau : plateaus) {
+        if ((int) routes.size() > k) break;
+        if (plateau.length < limits.localOptimality * best) continue;
+
+        path.clear();
+        at.clear();
+        viaRoute(plateau.first, path, at);
+
+        // The forward and backward halves may meet again, which would make a loop
+        unordered_set<int> visited(path.begin(), path.end());
+        if (visited.size() != path.size()) continue;
+
+        double shared = 0;
+        for (size_t i = 0; i + 1 < path.size(); i++) {
+            if (usedSegments.count(segmentKey(path[i], path[i + 1]))) shared += at[i + 1] - at[i];
+        }
+        if (shared > limits.maxSharing * best) continue;
+
+        keep(path, plateau.time, plateau.first, shared);
+    }
+    return routes;
+}
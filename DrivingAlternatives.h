@@ -0,0 +1,49 @@
+#ifndef DRIVING_ALTERNATIVES_H
+#define DRIVING_ALTERNATIVES_H
+
+#include <vector>
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
+
+/**
+ * Admissibility limits for alternative routes, as fractions of the shortest driving time d.
+ */
+struct AlternativeLimits {
+    double maxStretch = 0.25;        // an alternative takes at most (1 + maxStretch) * d
+    double maxSharing = 0.8;         // and shares at most maxSharing * d with the routes ranked before it
+    double localOptimality = 0.25;   // every piece of it up to localOptimality * d long is a shortest route
+};
+
+struct DrivingAlternative {
+    std::vector<int> path;   // CSV Ids, source ... destination
+    double time = 0;
+    int viaNode = -1;        // CSV Id of the first node of the plateau the route goes through, -1 for the best route
+    double sharedTime = 0;   // driving time on segments already used by the routes ranked before it
+};
+
+/**
+ * Best driving route followed by up to k ranked alternatives, all read from one driving tree
+ * grown from the source and one grown backwards from the destination (both cut off at the
+ * maximum stretch).
+ *
+ * A plateau is a maximal chain of edges that lies on both trees; the route through it follows
+ * the forward tree to its first node and the backward tree from there on. Every piece of such a
+ * route that does not cover the whole plateau lies on one of the trees, so the plateau length
+ * is exactly how locally optimal the route is. Plateaus are tried by route time (longer
+ * plateaus first on ties) and a route is kept if it is simple, within the stretch limit, long
+ * enough on its plateau, and shares little enough with the routes already kept.
+ *
+ * Returns an empty vector if destination cannot be reached; otherwise the first entry is the
+ * best route. The trees are left in forwardWs and backwardWs.
+ */
+std::vector<DrivingAlternative> findDrivingAlternatives(
+        const CsrGraph &graph,
+        int source,
+        int destination,
+        int k,
+        const AlternativeLimits &limits = {},
+        SearchWorkspace &forwardWs = SearchWorkspace::forThread(0),
+        SearchWorkspace &backwardWs = SearchWorkspace::forThread(1)
+);
+
+#endif // DRIVING_ALTERNATIVES_H
@@ -1,8 +1,11 @@
 #include "EnvFriendlyRoute.h"
+#include "BestRoute.h"
+#include "RestrictedRoute.h"
+#include "data_structures/SearchQueue.h"
 #include <queue>
-#include <unordered_map>
-#include <unordered_set>
 #include <limits>
+#include <numeric>
+#include <unordered_map>
 #include <algorithm>
 
 using namespace std;
@@ -16,148 +19,379 @@ bool isBlocked(int u, int v, const vector<pair<int, int>>& avoidSegments) {
            find(avoidSegments.begin(), avoidSegments.end(), make_pair(v, u)) != avoidSegments.end();
 }
 
-vector<int> reconstructPath(int src, int tgt, unordered_map<int, int>& prev) {
+/*
+ * Rebuilds the path ending at dense index tgt from the parents stored in ws.
+ */
+vector<int> reconstructPath(const Graph<int>& g, int tgt, const SearchWorkspace& ws) {
     vector<int> path;
-    for (int at = tgt; at != src; at = prev[at]) {
-        path.push_back(at);
+    for (int at = tgt; at != -1; at = ws.getParent(at)) {
+        path.push_back(g.getVertex(at)->getInfo());
     }
-    path.push_back(src);
     reverse(path.begin(), path.end());
     return path;
 }
 
-unordered_map<int, pair<double, vector<int>>> runDijkstra(
-        Graph<int>& g, int start,
+/*
+ * One-to-all Dijkstra from start; the distances and parents stay in ws.
+ * Returns the dense index of start, or -1 if it does not exist.
+ */
+int runDijkstra(
+        const Graph<int>& g, int start,
         bool useDriving,
         const vector<int>& avoidNodes,
-        const vector<pair<int, int>>& avoidSegments) {
+        const vector<pair<int, int>>& avoidSegments,
+        SearchWorkspace& ws) {
+
+    ws.reset(g.getNumVertex());
+    int s = g.findVertexIdx(start);
+    if (s == -1) return -1;
+
+    // All per-vertex state is indexed by the graph's dense vertex index
+    vector<char> avoided(g.getNumVertex(), 0);
+    for (int node : avoidNodes) {
+        int idx = g.findVertexIdx(node);
+        if (idx != -1) avoided[idx] = 1;
+    }
 
-    unordered_map<int, double> dist;
-    unordered_map<int, int> prev;
     priority_queue<pair<double, int>, vector<pair<double, int>>, greater<>> pq;
 
-    for (auto v : g.getVertexSet()) {
-        dist[v->getInfo()] = INF;
-    }
-
-    dist[start] = 0;
-    pq.emplace(0, start);
+    ws.setDist(s, 0);
+    pq.emplace(0, s);
 
     while (!pq.empty()) {
         auto [cost, u] = pq.top(); pq.pop();
+        if (cost > ws.getDist(u)) continue; // stale entry
 
-        if (isAvoided(u, avoidNodes)) continue;
-        Vertex<int>* v = g.findVertex(u);
-        if (!v) continue;
+        if (avoided[u]) continue;
+        Vertex<int>* v = g.getVertex(u);
 
         for (auto e : v->getAdj()) {
-            int next = e->getDest()->getInfo();
-            if (isAvoided(next, avoidNodes)) continue;
-            if (isBlocked(u, next, avoidSegments)) continue;
+            int next = e->getDest()->getIndex();
+            if (avoided[next]) continue;
+            if (isBlocked(v->getInfo(), e->getDest()->getInfo(), avoidSegments)) continue;
 
             double weight = useDriving ? e->getDrivingWeight() : e->getWalkingWeight();
             if (weight >= INF) continue;
 
-            if (dist[next] > dist[u] + weight) {
-                dist[next] = dist[u] + weight;
-                prev[next] = u;
-                pq.emplace(dist[next], next);
+            if (ws.getDist(next) > cost + weight) {
+                ws.setDist(next, cost + weight);
+                ws.setParent(next, u);
+                pq.emplace(cost + weight, next);
             }
         }
     }
 
-    unordered_map<int, pair<double, vector<int>>> result;
-    for (auto& [node, d] : dist) {
-        if (d < INF && node != start && prev.count(node)) {
-            result[node] = {d, reconstructPath(start, node, prev)};
-        }
-    }
-
-    return result;
+    return s;
 }
 
-EnvFriendlyRoute findEnvFriendlyRoute(
-        Graph<int>& g,
-        int source,
-        int destination,
+/*
+ * Joins the driving tree from the source (in driveWs) with the walking tree from the
+ * destination (in walkWs) over the given nodes (dense indices): every parking node reached by
+ * both searches (other than their roots) within maxWalk becomes an option. Only distances are
+ * read. anyParking is set if the driving search reached any of the parking nodes among nodes.
+ */
+template <class IsParking>
+vector<ParkingOption> collectParkingOptions(
+        const vector<int>& nodes,
+        const SearchWorkspace& driveWs,
+        const SearchWorkspace& walkWs,
         double maxWalk,
-        const std::vector<int>& avoidNodes,
-        const std::vector<std::pair<int, int>>& avoidSegments) {
-
-    // Run Dijkstra for both driving and walking paths
-    auto driveMap = runDijkstra(g, source, true, avoidNodes, avoidSegments); // Driving route
-    auto walkMap = runDijkstra(g, destination, false, avoidNodes, avoidSegments); // Reversed Walking route
+        IsParking isParking,
+        bool& anyParking) {
 
-    std::vector<EnvFriendlyRoute> validRoutes;
+    // A node counts as reached if a search found it through at least one edge
+    auto reached = [](const SearchWorkspace& ws, int v) {
+        return ws.getDist(v) < INF && ws.getParent(v) != -1;
+    };
 
-    // Try to find valid routes with driving + walking
-    for (auto& [parkingNode, driveInfo] : driveMap) {
-        Vertex<int>* pv = g.findVertex(parkingNode);
-        if (!pv || pv->getParking() != 1) continue; // Skip nodes that are not parking nodes
-
-        if (!walkMap.count(parkingNode)) continue; // Skip if no walking path from this parking node
-        auto [walkTime, walkPath] = walkMap[parkingNode];
+    vector<ParkingOption> options;
+    for (int v : nodes) {
+        if (!reached(driveWs, v) || !isParking(v)) continue; // Skip nodes that are not parking nodes
+        anyParking = true;
 
+        if (!reached(walkWs, v)) continue; // Skip if no walking path from this parking node
+        double walkTime = walkWs.getDist(v);
         if (walkTime > maxWalk) continue; // Skip if walking time exceeds maximum allowed
 
-        reverse(walkPath.begin(), walkPath.end()); // Reverse walking path to go from parking to destination
-
         // Calculate the total time (driving + walking)
-        double totalTime = driveInfo.first + walkTime;
-
-        // Add the valid route (driving + walking path)
-        validRoutes.push_back({
-            parkingNode,
-            driveInfo.first,
-            walkTime,
-            totalTime,
-            driveInfo.second,
-            walkPath
-        });
+        options.push_back({v, driveWs.getDist(v), walkTime, driveWs.getDist(v) + walkTime});
     }
+    return options;
+}
 
+/*
+ * Sorts options first by total time, then by walking time (descending).
+ */
+void sortParkingOptions(vector<ParkingOption>& options) {
+    sort(options.begin(), options.end(), [](const auto& a, const auto& b) {
+        if (a.totalTime != b.totalTime) return a.totalTime < b.totalTime;
+        return a.walkingTime > b.walkingTime; // Prefer routes with less walking time
+    });
+}
+
+string envFailureMessage(bool anyParkingReached) {
+    return anyParkingReached
+           ? "All walking routes from parking exceed max walking time."
+           : "No parking nodes reachable from source and walking routes exceed max walking time.";
+}
+
+/*
+ * Rebuilds the paths of one option; pathTo(ws, v) returns the Ids from the search root to v.
+ */
+template <class PathTo>
+EnvFriendlyRoute materializeOption(const ParkingOption& option, const SearchWorkspace& driveWs,
+                                   const SearchWorkspace& walkWs, PathTo pathTo) {
+    auto walkPath = pathTo(walkWs, option.node);
+    reverse(walkPath.begin(), walkPath.end()); // Reverse walking path to go from parking to destination
+    auto drivePath = pathTo(driveWs, option.node);
+    return EnvFriendlyRoute{drivePath.back(), option.drivingTime, option.walkingTime, option.totalTime,
+                            drivePath, walkPath};
+}
+
+/*
+ * Best option plus at most one alternative, or the failure message if there is none.
+ * Paths are only rebuilt for the options that are returned.
+ */
+template <class PathTo>
+EnvFriendlyRoute selectEnvRoute(
+        vector<ParkingOption>& validRoutes,
+        bool anyParkingCandidate,
+        const SearchWorkspace& driveWs,
+        const SearchWorkspace& walkWs,
+        PathTo pathTo) {
 
     if (validRoutes.empty()) {
-        bool anyParkingCandidate = false;
-        bool anyWalkableCandidate = false;
+        return EnvFriendlyRoute{-1, 0, 0, 0, {}, {}, envFailureMessage(anyParkingCandidate)};
+    }
 
-        for (auto& [parkingNode, driveInfo] : driveMap) {
-            Vertex<int>* pv = g.findVertex(parkingNode);
-            if (!pv || pv->getParking() != 1) continue;
+    sortParkingOptions(validRoutes);
 
-            anyParkingCandidate = true;
+    // Prepare the best route and alternatives (limit to 2 alternatives)
+    EnvFriendlyRoute bestRoute = materializeOption(validRoutes[0], driveWs, walkWs, pathTo); // The best route
+    for (size_t i = 1; i < validRoutes.size() && i < 2; ++i) {
+        bestRoute.alternatives.push_back(materializeOption(validRoutes[i], driveWs, walkWs, pathTo)); // Add second alternative if exists
+    }
+
+    return bestRoute;
+}
+
+vector<ParkingOption> findParkingOptions(
+        const Graph<int>& g,
+        int source,
+        int destination,
+        double maxWalk,
+        const std::vector<int>& avoidNodes,
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs,
+        SearchWorkspace& walkWs,
+        bool* anyParking) {
+
+    // Run Dijkstra for both driving and walking paths
+    runDijkstra(g, source, true, avoidNodes, avoidSegments, driveWs); // Driving route
+    runDijkstra(g, destination, false, avoidNodes, avoidSegments, walkWs); // Reversed Walking route
+
+    vector<int> nodes(g.getNumVertex());
+    iota(nodes.begin(), nodes.end(), 0);
+    bool reachedParking = false;
+    auto options = collectParkingOptions(nodes, driveWs, walkWs, maxWalk,
+                                         [&g](int v) { return g.getVertex(v)->getParking() == 1; }, reachedParking);
+    if (anyParking) *anyParking = reachedParking;
+    return options;
+}
+
+EnvFriendlyRoute makeEnvRoute(const Graph<int>& g, const ParkingOption& option,
+                              const SearchWorkspace& driveWs, const SearchWorkspace& walkWs) {
+    return materializeOption(option, driveWs, walkWs,
+                             [&g](const SearchWorkspace& ws, int v) { return reconstructPath(g, v, ws); });
+}
 
-            if (walkMap.count(parkingNode)) {
-                auto [walkTime, _] = walkMap[parkingNode];
-                if (walkTime <= maxWalk) {
-                    anyWalkableCandidate = true;
-                    break;
+EnvFriendlyRoute findEnvFriendlyRoute(
+        const Graph<int>& g,
+        int source,
+        int destination,
+        double maxWalk,
+        const std::vector<int>& avoidNodes,
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs,
+        SearchWorkspace& walkWs) {
+
+    bool anyParking = false;
+    auto options = findParkingOptions(g, source, destination, maxWalk, avoidNodes, avoidSegments, driveWs, walkWs, &anyParking);
+    return selectEnvRoute(options, anyParking, driveWs, walkWs,
+                          [&g](const SearchWorkspace& ws, int v) { return reconstructPath(g, v, ws); });
+}
+
+vector<int> findWalkableParking(const CsrGraph& g, int s, int t, double maxWalk,
+                                const vector<char>& blockedNodes, const vector<char>& blockedEdges,
+                                SearchWorkspace& walkWs) {
+    vector<int> candidates;
+    walkWs.reset(g.getNumVertex());
+    if (t == -1 || blockedNodes[t] || g.getParkingVertices().empty()) return candidates;
+
+    walkWs.setDist(t, 0);
+    withSearchQueue(g, [&](auto makeQueue) {
+        auto q = makeQueue(walkWs);
+        q.insert(t);
+
+        while (!q.empty()) {
+            int v = q.extractMin();
+            double d = walkWs.getDist(v);
+            if (d > maxWalk) break; // everything left is outside the walking radius
+            if (v != t && v != s && g.getParking(v)) candidates.push_back(v);
+
+            for (int e = g.edgeBegin(v); e < g.edgeEnd(v); e++) {
+                int w = g.getTarget(e);
+                if (blockedNodes[w] || blockedEdges[e]) continue;
+
+                auto oldDist = walkWs.getDist(w);
+                if (d + g.getWalkingWeight(e) < oldDist) {
+                    walkWs.setDist(w, d + g.getWalkingWeight(e));
+                    walkWs.setParent(w, v);
+                    if (oldDist == INF) q.insert(w);
+                    else q.decreaseKey(w);
                 }
             }
         }
+    });
+    return candidates;
+}
 
-        string reason;
-        if (!anyParkingCandidate && !anyWalkableCandidate) {
-            reason = "No parking nodes reachable from source and walking routes exceed max walking time.";
-        } else if (!anyParkingCandidate) {
-            reason = "No parking nodes reachable from source.";
-        } else {
-            reason = "All walking routes from parking exceed max walking time.";
-        }
-        return EnvFriendlyRoute{-1, 0, 0, 0, {}, {}, reason};
-    }
+/*
+ * Driving Dijkstra from dense index s towards the candidates returned by findWalkableParking
+ * (nearest first, walking distances in walkWs). It stops once every candidate is settled and,
+ * with stopAtTopTwo, as soon as no unsettled candidate (whose walk is at least that of the
+ * nearest unsettled one) can beat the second best total found so far. Candidates left
+ * unsettled then only carry upper bounds, which already lose to the top two.
+ * Returns whether any parking node other than s was settled.
+ */
+bool driveToParking(const CsrGraph& g, int s, const vector<int>& candidates,
+                    const vector<char>& blockedNodes, const vector<char>& blockedEdges,
+                    const SearchWorkspace& walkWs, SearchWorkspace& driveWs, bool stopAtTopTwo) {
+    bool parkingReached = false;
+    driveWs.reset(g.getNumVertex());
+    if (s == -1 || blockedNodes[s]) return false;
+
+    unordered_map<int, int> candidatePos;
+    for (size_t i = 0; i < candidates.size(); i++) candidatePos[candidates[i]] = i;
+    vector<char> settled(candidates.size(), 0);
+    size_t numSettled = 0, nearestUnsettled = 0;
+    double best = INF, secondBest = INF;
+
+    driveWs.setDist(s, 0);
+    withSearchQueue(g, [&](auto makeQueue) {
+        auto q = makeQueue(driveWs);
+        q.insert(s);
+
+        while (!q.empty()) {
+            int v = q.extractMin();
+            double d = driveWs.getDist(v);
+            if (stopAtTopTwo && nearestUnsettled < candidates.size()
+                && d + walkWs.getDist(candidates[nearestUnsettled]) > secondBest) break;
+
+            if (v != s && g.getParking(v)) {
+                parkingReached = true;
+                if (candidates.empty()) break; // only needed to pick the failure message
+
+                auto it = candidatePos.find(v);
+                if (it != candidatePos.end()) {
+                    settled[it->second] = 1;
+                    if (++numSettled == candidates.size()) break;
+                    while (settled[nearestUnsettled]) nearestUnsettled++;
+
+                    double total = d + walkWs.getDist(v);
+                    if (total < best) {
+                        secondBest = best;
+                        best = total;
+                    } else if (total < secondBest) {
+                        secondBest = total;
+                    }
+                }
+            }
 
-    // Sort the valid routes first by total time, then by walking time (descending)
-    sort(validRoutes.begin(), validRoutes.end(), [](const auto& a, const auto& b) {
-        if (a.totalTime != b.totalTime) return a.totalTime < b.totalTime;
-        return a.walkingTime > b.walkingTime; // Prefer routes with less walking time
+            for (int e = g.edgeBegin(v); e < g.edgeEnd(v); e++) {
+                int w = g.getTarget(e);
+                if (blockedNodes[w] || blockedEdges[e]) continue;
+                double weight = g.getDrivingWeight(e);
+                if (weight == INF) continue;
+
+                auto oldDist = driveWs.getDist(w);
+                if (d + weight < oldDist) {
+                    driveWs.setDist(w, d + weight);
+                    driveWs.setParent(w, v);
+                    if (oldDist == INF) q.insert(w);
+                    else q.decreaseKey(w);
+                }
+            }
+        }
     });
+    return parkingReached;
+}
 
-    // Prepare the best route and alternatives (limit to 2 alternatives)
-    EnvFriendlyRoute bestRoute = validRoutes[0]; // The best route
-    for (size_t i = 1; i < validRoutes.size() && i < 2; ++i) {
-        bestRoute.alternatives.push_back(validRoutes[i]); // Add second alternative if exists
-    }
+/*
+ * Bounded walking search, then the driving search towards its parking nodes.
+ */
+vector<ParkingOption> boundedParkingOptions(
+        const CsrGraph& g,
+        int source,
+        int destination,
+        double maxWalk,
+        const std::vector<int>& avoidNodes,
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs,
+        SearchWorkspace& walkWs,
+        bool stopAtTopTwo,
+        bool& anyParking) {
+
+    int s = g.getIndex(source);
+    int t = g.getIndex(destination);
+    vector<char> blockedNodes, blockedEdges;
+    buildAvoidMasks(g, avoidNodes, avoidSegments, blockedNodes, blockedEdges);
+
+    auto candidates = findWalkableParking(g, s, t, maxWalk, blockedNodes, blockedEdges, walkWs);
+    bool parkingReached = driveToParking(g, s, candidates, blockedNodes, blockedEdges, walkWs, driveWs, stopAtTopTwo);
+    auto options = collectParkingOptions(candidates, driveWs, walkWs, maxWalk,
+                                         [&g](int v) { return g.getParking(v) == 1; }, anyParking);
+    anyParking = anyParking || parkingReached;
+    return options;
+}
 
-    return bestRoute;
-}
\ No newline at end of file
+vector<ParkingOption> findParkingOptions(
+        const CsrGraph& g,
+        int source,
+        int destination,
+        double maxWalk,
+        const std::vector<int>& avoidNodes,
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs,
+        SearchWorkspace& walkWs,
+        bool* anyParking) {
+
+    bool reachedParking = false;
+    auto options = boundedParkingOptions(g, source, destination, maxWalk, avoidNodes, avoidSegments,
+                                         driveWs, walkWs, false, reachedParking);
+    if (anyParking) *anyParking = reachedParking;
+    return options;
+}
+
+EnvFriendlyRoute makeEnvRoute(const CsrGraph& g, const ParkingOption& option,
+                              const SearchWorkspace& driveWs, const SearchWorkspace& walkWs) {
+    return materializeOption(option, driveWs, walkWs,
+                             [&g](const SearchWorkspace& ws, int v) { return buildCsrPath(g, ws, v); });
+}
+
+EnvFriendlyRoute findEnvFriendlyRoute(
+        const CsrGraph& g,
+        int source,
+        int destination,
+        double maxWalk,
+        const std::vector<int>& avoidNodes,
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs,
+        SearchWorkspace& walkWs) {
+
+    bool anyParking = false;
+    auto options = boundedParkingOptions(g, source, destination, maxWalk, avoidNodes, avoidSegments,
+                                         driveWs, walkWs, true, anyParking);
+    return selectEnvRoute(options, anyParking, driveWs, walkWs,
+                          [&g](const SearchWorkspace& ws, int v) { return buildCsrPath(g, ws, v); });
+}
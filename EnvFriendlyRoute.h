@@ -4,6 +4,8 @@
 #include <vector>
 #include <string>
 #include "data_structures/Graph.h"
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
 
 struct EnvFriendlyRoute {
     int parkingNode = -1;
@@ -18,13 +20,114 @@ struct EnvFriendlyRoute {
     std::vector<EnvFriendlyRoute> alternatives;
 };
 
+/**
+ * The driving tree from the source and the walking tree from the destination are kept in
+ * driveWs and walkWs (by default the calling thread's own workspaces); the graph is only read.
+ * Candidates are compared on the distance arrays alone, and paths are only built for the
+ * returned route and its alternative.
+ */
 EnvFriendlyRoute findEnvFriendlyRoute(
-        Graph<int>& graph,
+        const Graph<int>& graph,
         int source,
         int destination,
         double maxWalkTime,
         const std::vector<int>& avoidNodes,
-        const std::vector<std::pair<int, int>>& avoidSegments
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs = SearchWorkspace::forThread(0),
+        SearchWorkspace& walkWs = SearchWorkspace::forThread(1)
+);
+
+/**
+ * Same query answered on an immutable CSR snapshot.
+ * The walking search from the destination stops at the maxWalkTime radius, and the driving
+ * search stops once every parking node inside it is settled or none of the remaining ones
+ * can beat the second best total, so the cost follows the destination's neighbourhood.
+ */
+EnvFriendlyRoute findEnvFriendlyRoute(
+        const CsrGraph& graph,
+        int source,
+        int destination,
+        double maxWalkTime,
+        const std::vector<int>& avoidNodes,
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs = SearchWorkspace::forThread(0),
+        SearchWorkspace& walkWs = SearchWorkspace::forThread(1)
+);
+
+/**
+ * One usable parking node of an env query: drive there from the source, then walk to the
+ * destination. node is a dense vertex index of the graph the option was computed on.
+ */
+struct ParkingOption {
+    int node = -1;
+    double drivingTime = 0;
+    double walkingTime = 0;
+    double totalTime = 0;
+};
+
+/**
+ * Every parking node that can be reached by car from source and lies within maxWalkTime of
+ * destination, with its shortest driving and walking times, in no particular order.
+ * The search trees stay in driveWs / walkWs so makeEnvRoute can rebuild the paths of the
+ * options that are kept. If anyParking is given, it is set when the driving search reached
+ * any parking node at all (which decides the failure message).
+ */
+std::vector<ParkingOption> findParkingOptions(
+        const Graph<int>& graph,
+        int source,
+        int destination,
+        double maxWalkTime,
+        const std::vector<int>& avoidNodes,
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs = SearchWorkspace::forThread(0),
+        SearchWorkspace& walkWs = SearchWorkspace::forThread(1),
+        bool* anyParking = nullptr
+);
+std::vector<ParkingOption> findParkingOptions(
+        const CsrGraph& graph,
+        int source,
+        int destination,
+        double maxWalkTime,
+        const std::vector<int>& avoidNodes,
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs = SearchWorkspace::forThread(0),
+        SearchWorkspace& walkWs = SearchWorkspace::forThread(1),
+        bool* anyParking = nullptr
+);
+
+/**
+ * Orders options the way env routes are ranked: total time ascending, then more walking first.
+ */
+void sortParkingOptions(std::vector<ParkingOption>& options);
+
+/**
+ * Message of an env query without a usable parking node; anyParkingReached tells whether the
+ * source could drive to some parking node at all.
+ */
+std::string envFailureMessage(bool anyParkingReached);
+
+/**
+ * Full route (Ids and paths) for an option, read from the workspaces findParkingOptions filled.
+ */
+EnvFriendlyRoute makeEnvRoute(const Graph<int>& graph, const ParkingOption& option,
+                              const SearchWorkspace& driveWs, const SearchWorkspace& walkWs);
+EnvFriendlyRoute makeEnvRoute(const CsrGraph& graph, const ParkingOption& option,
+                              const SearchWorkspace& driveWs, const SearchWorkspace& walkWs);
+
+/**
+ * Walking Dijkstra from dense index t (over outgoing edges, like the env walking tree) that
+ * stops at the maxWalk radius. Returns the parking vertices other than s and t inside it,
+ * nearest first; their walking distances and parents are left in walkWs. Masks are indexed
+ * as in buildAvoidMasks.
+ */
+std::vector<int> findWalkableParking(
+        const CsrGraph& graph,
+        int s,
+        int t,
+        double maxWalk,
+        const std::vector<char>& blockedNodes,
+        const std::vector<char>& blockedEdges,
+        SearchWorkspace& walkWs
 );
 
 #endif // ENVFRIENDLYROUTE_H
@@ -0,0 +1,152 @@
+#include "GraphSnapshot.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+const char snapshotMagic[8] = {'D', 'A', 'G', 'R', 'A', 'P', 'H', 0};
+const uint32_t snapshotVersion = 2; // 2: float weights
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numVertex;
+    uint32_t numEdges;
+    uint32_t numParking;
+    uint32_t numStrings;
+    uint32_t integralWeights;
+    uint64_t stringBytes;
+    double maxWeight;
+    uint64_t checksum;   // snapshotChecksum of everything after the header
+};
+
+/*
+ * FNV-1a style hash taken eight bytes at a time, so checking a large snapshot costs about as
+ * much as reading it.
+ */
+uint64_t snapshotChecksum(const char *data, size_t size) {
+    uint64_t hash = 1469598103934665603ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    for (; i < size; i++) hash = (hash ^ (unsigned char) data[i]) * 1099511628211ULL;
+    return hash;
+}
+
+/*
+ * Byte size of a section holding count elements of size elementSize, padded to 8 bytes so every
+ * section starts aligned.
+ */
+size_t sectionSize(size_t count, size_t elementSize) {
+    return (count * elementSize + 7) / 8 * 8;
+}
+
+bool writeGraphSnapshot(const CsrGraph &graph, const string &path) {
+    ofstream file(path, ios::binary);
+    if (!file) return false;
+
+    // Payload first, so the checksum can go into the header
+    string payload;
+    auto append = [&](auto values) {
+        size_t begin = payload.size();
+        payload.resize(begin + sectionSize(values.size(), sizeof(values[0])), '\0');
+        if (!values.empty()) memcpy(payload.data() + begin, values.data(), values.size() * sizeof(values[0]));
+    };
+    append(graph.drivingWeights);
+    append(graph.walkingWeights);
+    append(graph.offsets);
+    append(graph.targets);
+    append(graph.inOffsets);
+    append(graph.inSources);
+    append(graph.inEdges);
+    append(graph.ids);
+    append(graph.idOrder);
+    append(graph.parkingVertices);
+    append(graph.locationNames);
+    append(graph.codeNames);
+    append(graph.stringOffsets);
+    append(graph.parking);
+    append(graph.stringData);
+
+    SnapshotHeader header{};
+    memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = snapshotVersion;
+    header.numVertex = graph.getNumVertex();
+    header.numEdges = graph.getNumEdges();
+    header.numParking = graph.parkingVertices.size();
+    header.numStrings = graph.stringOffsets.size() - 1;
+    header.integralWeights = graph.integralWeights;
+    header.stringBytes = graph.stringData.size();
+    header.maxWeight = graph.maxWeight;
+    header.checksum = snapshotChecksum(payload.data(), payload.size());
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(payload.data(), payload.size());
+    return (bool) file;
+}
+
+unique_ptr<CsrGraph> loadGraphSnapshot(const string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) return nullptr;
+
+    struct stat info {};
+    void *mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t) info.st_size >= sizeof(SnapshotHeader)) {
+        mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd); // the mapping keeps the file open
+    if (mapped == MAP_FAILED) return nullptr;
+
+    size_t fileSize = info.st_size;
+    shared_ptr<const void> mapping(mapped, [fileSize](const void *p) { munmap(const_cast<void *>(p), fileSize); });
+    const char *base = static_cast<const char *>(mapped);
+    SnapshotHeader h;
+    memcpy(&h, base, sizeof(h));
+    if (memcmp(h.magic, snapshotMagic, sizeof(snapshotMagic)) != 0 || h.version != snapshotVersion) return nullptr;
+
+    size_t n = h.numVertex, m = h.numEdges;
+    size_t expected = sizeof(SnapshotHeader)
+            + 2 * sectionSize(m, sizeof(float))
+            + sectionSize(n + 1, sizeof(int)) + 3 * sectionSize(m, sizeof(int)) + sectionSize(n + 1, sizeof(int))
+            + 2 * sectionSize(n, sizeof(int)) + sectionSize(h.numParking, sizeof(int))
+            + 2 * sectionSize(n, sizeof(int)) + sectionSize(h.numStrings + 1, sizeof(int))
+            + sectionSize(n, sizeof(char)) + sectionSize(h.stringBytes, sizeof(char));
+    if (fileSize != expected) return nullptr;
+    const char *payload = base + sizeof(SnapshotHeader);
+    if (snapshotChecksum(payload, fileSize - sizeof(SnapshotHeader)) != h.checksum) return nullptr;
+
+    unique_ptr<CsrGraph> graph(new CsrGraph());
+    const char *cursor = payload;
+    auto take = [&](auto &view, size_t count) {
+        using Element = typename remove_reference_t<decltype(view)>::element_type;
+        view = {reinterpret_cast<Element *>(cursor), count};
+        cursor += sectionSize(count, sizeof(Element));
+    };
+    take(graph->drivingWeights, m);
+    take(graph->walkingWeights, m);
+    take(graph->offsets, n + 1);
+    take(graph->targets, m);
+    take(graph->inOffsets, n + 1);
+    take(graph->inSources, m);
+    take(graph->inEdges, m);
+    take(graph->ids, n);
+    take(graph->idOrder, n);
+    take(graph->parkingVertices, h.numParking);
+    take(graph->locationNames, n);
+    take(graph->codeNames, n);
+    take(graph->stringOffsets, h.numStrings + 1);
+    take(graph->parking, n);
+    take(graph->stringData, h.stringBytes);
+    graph->integralWeights = h.integralWeights;
+    graph->maxWeight = h.maxWeight;
+    graph->mapping = std::move(mapping);
+    return graph;
+}
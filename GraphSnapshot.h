@@ -0,0 +1,31 @@
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include <string>
+#include <memory>
+#include "data_structures/CsrGraph.h"
+
+/**
+ * Binary snapshot of a CsrGraph: a versioned header, then every CSR array (topology in both
+ * directions, both weight kinds, Ids, parking flags and the interned location/code strings)
+ * exactly as it sits in memory, each array aligned for its element type. A checksum over
+ * everything after the header catches truncated or damaged files.
+ *
+ * Written once with writeGraphSnapshot (Tools > Export Graph Snapshot), after which a process
+ * can start from loadGraphSnapshot instead of parsing the CSV files. Snapshots are native
+ * byte order and only meant for the machine that wrote them.
+ */
+
+/**
+ * Returns false if the file cannot be written.
+ */
+bool writeGraphSnapshot(const CsrGraph &graph, const std::string &path);
+
+/**
+ * Maps the file read-only and points the graph's arrays straight into the mapping; nothing is
+ * parsed or copied, and pages are only read once a query touches them. Returns nullptr if the
+ * file is missing, of another version, truncated, or fails its checksum.
+ */
+std::unique_ptr<CsrGraph> loadGraphSnapshot(const std::string &path);
+
+#endif // GRAPH_SNAPSHOT_H
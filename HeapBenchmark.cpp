@@ -0,0 +1,85 @@
+#include "HeapBenchmark.h"
+#include "data_structures/SearchWorkspace.h"
+#include "data_structures/IndexedPriorityQueue.h"
+#include "data_structures/DaryHeap.h"
+#include "data_structures/DialQueue.h"
+#include "data_structures/RadixHeap.h"
+#include <chrono>
+#include <iomanip>
+#include <string>
+
+using namespace std;
+
+/*
+ * One-to-all Dijkstra from s with the queue built by makeQueue; returns the sum of the
+ * finite distances so the queues can be checked against each other.
+ */
+template <class MakeQueue>
+double benchmarkSearch(const CsrGraph &graph, int s, bool useDriving, SearchWorkspace &ws, MakeQueue makeQueue) {
+    ws.reset(graph.getNumVertex());
+    ws.setDist(s, 0);
+    auto q = makeQueue(ws);
+    q.insert(s);
+
+    double checksum = 0;
+    while (!q.empty()) {
+        int v = q.extractMin();
+        double d = ws.getDist(v);
+        checksum += d;
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+            double weight = useDriving ? graph.getDrivingWeight(e) : graph.getWalkingWeight(e);
+            if (weight == INF) continue;
+
+            int w = graph.getTarget(e);
+            auto oldDist = ws.getDist(w);
+            if (d + weight < oldDist) {
+                ws.setDist(w, d + weight);
+                if (oldDist == INF) q.insert(w);
+                else q.decreaseKey(w);
+            }
+        }
+    }
+    return checksum;
+}
+
+template <class MakeQueue>
+void benchmarkQueue(const CsrGraph &graph, const string &name, int numSources, ostream &out, MakeQueue makeQueue) {
+    int n = graph.getNumVertex();
+    SearchWorkspace ws(n);
+    int step = max(1, n / max(1, numSources));
+
+    // Warm-up pass so the first queue measured does not pay for cold caches
+    benchmarkSearch(graph, 0, true, ws, makeQueue);
+
+    double checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int s = 0; s < n; s += step) {
+        checksum += benchmarkSearch(graph, s, true, ws, makeQueue);
+        checksum += benchmarkSearch(graph, s, false, ws, makeQueue);
+    }
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    out << left << setw(22) << name << right << fixed << setprecision(2) << setw(10) << ms << " ms"
+        << "   checksum " << setprecision(0) << checksum << "\n";
+}
+
+void runHeapBenchmark(const CsrGraph &graph, ostream &out, int numSources) {
+    if (graph.getNumVertex() == 0) return;
+    out << "One-to-all Dijkstra (driving + walking) from " << min(numSources, graph.getNumVertex())
+        << " sources on " << graph.getNumVertex() << " vertices / " << graph.getNumEdges() << " edges\n";
+
+    benchmarkQueue(graph, "IndexedPriorityQueue", numSources, out,
+                   [](SearchWorkspace &ws) { return IndexedPriorityQueue(ws); });
+    benchmarkQueue(graph, "DaryHeap<2>", numSources, out, [](SearchWorkspace &ws) { return DaryHeap<2>(ws); });
+    benchmarkQueue(graph, "DaryHeap<4>", numSources, out, [](SearchWorkspace &ws) { return DaryHeap<4>(ws); });
+    benchmarkQueue(graph, "DaryHeap<8>", numSources, out, [](SearchWorkspace &ws) { return DaryHeap<8>(ws); });
+
+    if (graph.hasIntegralWeights()) {
+        if (graph.getMaxWeight() <= DialQueue::MAX_BUCKETS) {
+            unsigned maxWeight = graph.getMaxWeight();
+            benchmarkQueue(graph, "DialQueue", numSources, out,
+                           [maxWeight](SearchWorkspace &ws) { return DialQueue(ws, maxWeight); });
+        }
+        benchmarkQueue(graph, "RadixHeap", numSources, out, [](SearchWorkspace &ws) { return RadixHeap(ws); });
+    }
+}
@@ -0,0 +1,15 @@
+#ifndef HEAP_BENCHMARK_H
+#define HEAP_BENCHMARK_H
+
+#include <iostream>
+#include "data_structures/CsrGraph.h"
+
+/**
+ * Times one-to-all driving and walking Dijkstra from numSources evenly spread sources with
+ * each priority queue: the binary IndexedPriorityQueue, DaryHeap with arity 2, 4 and 8, and
+ * (for integral weights) DialQueue and RadixHeap. Every queue runs the same searches, and a
+ * checksum of the settled distances confirms they agree. Writes one line per queue to out.
+ */
+void runHeapBenchmark(const CsrGraph &graph, std::ostream &out, int numSources = 200);
+
+#endif // HEAP_BENCHMARK_H
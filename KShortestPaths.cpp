@@ -0,0 +1,227 @@
+#include "KShortestPaths.h"
+#include "RestrictedRoute.h"
+#include "data_structures/SearchQueue.h"
+#include <algorithm>
+#include <queue>
+#include <set>
+#include <tuple>
+
+using namespace std;
+
+/*
+ * A route found so far or waiting to be searched: the spur at position spurIndex of an earlier
+ * route. Until resolved, time is only a lower bound and path is empty.
+ */
+struct SpurCandidate {
+    double time;
+    int base;
+    int spurIndex;
+    bool resolved = false;
+    vector<int> path;    // dense indices
+    vector<double> at;   // driving time at each vertex of path
+};
+
+/*
+ * Driving Dijkstra towards dense index t over incoming edges; the parent of a vertex is the
+ * next one on its shortest route to t.
+ */
+void reverseDrivingTree(const CsrGraph &graph, int t, const vector<char> &blockedNodes,
+                        const vector<char> &blockedEdges, SearchWorkspace &ws) {
+    ws.reset(graph.getNumVertex());
+    ws.setDist(t, 0);
+    withSearchQueue(graph, [&](auto makeQueue) {
+        auto q = makeQueue(ws);
+        q.insert(t);
+
+        while (!q.empty()) {
+            int v = q.extractMin();
+            double d = ws.getDist(v);
+            for (int k = graph.inEdgeBegin(v); k < graph.inEdgeEnd(v); k++) {
+                int u = graph.getInSource(k);
+                int e = graph.getInEdge(k);
+                if (blockedNodes[u] || blockedEdges[e]) continue;
+                double weight = graph.getDrivingWeight(e);
+                if (weight == INF) continue;
+
+                auto oldDist = ws.getDist(u);
+                if (d + weight < oldDist) {
+                    ws.setDist(u, d + weight);
+                    ws.setParent(u, v);
+                    if (oldDist == INF) q.insert(u);
+                    else q.decreaseKey(u);
+                }
+            }
+        }
+    });
+}
+
+/*
+ * Fastest route from spur to t that enters no vertex flagged in onRoot and does not leave
+ * spur towards any vertex in forbiddenNext. Appends it (spur excluded) to path and the
+ * driving time from spur to at, and returns that time (INF if there is none).
+ */
+double searchSpur(const CsrGraph &graph, int spur, int t, const vector<char> &blockedNodes,
+                  const vector<char> &blockedEdges, const vector<char> &onRoot,
+                  const vector<int> &forbiddenNext, const SearchWorkspace &reverseWs,
+                  SearchWorkspace &ws, vector<int> &path, vector<double> &at) {
+    auto forbidden = [&](int v) {
+        return find(forbiddenNext.begin(), forbiddenNext.end(), v) != forbiddenNext.end();
+    };
+
+    // The shared tree's own route, if nothing on it has been ruled out
+    bool treeRouteOpen = reverseWs.getParent(spur) != -1 && !forbidden(reverseWs.getParent(spur));
+    for (int v = reverseWs.getParent(spur); treeRouteOpen && v != -1; v = reverseWs.getParent(v)) {
+        if (onRoot[v]) treeRouteOpen = false;
+    }
+    if (treeRouteOpen) {
+        double total = reverseWs.getDist(spur);
+        for (int v = reverseWs.getParent(spur); v != -1; v = reverseWs.getParent(v)) {
+            path.push_back(v);
+            at.push_back(total - reverseWs.getDist(v));
+        }
+        return total;
+    }
+
+    // A* with the tree distances, exact without the extra restrictions and so consistent
+    ws.reset(graph.getNumVertex());
+    priority_queue<tuple<double, double, int>, vector<tuple<double, double, int>>, greater<>> pq;
+    ws.setDist(spur, 0);
+    pq.emplace(reverseWs.getDist(spur), 0, spur);
+
+    while (!pq.empty()) {
+        auto [f, g, v] = pq.top(); pq.pop();
+        if (g > ws.getDist(v)) continue;
+        if (v == t) break;
+
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+            int w = graph.getTarget(e);
+            if (blockedNodes[w] || blockedEdges[e] || onRoot[w]) continue;
+            if (v == spur && forbidden(w)) continue;
+            double weight = graph.getDrivingWeight(e);
+            double h = reverseWs.getDist(w);
+            if (weight == INF || h == INF) continue;
+
+            if (g + weight < ws.getDist(w)) {
+                ws.setDist(w, g + weight);
+                ws.setParent(w, v);
+                pq.emplace(g + weight + h, g + weight, w);
+            }
+        }
+    }
+    if (ws.getDist(t) == INF) return INF;
+
+    size_t first = path.size();
+    for (int v = t; v != spur; v = ws.getParent(v)) path.push_back(v);
+    reverse(path.begin() + first, path.end());
+    for (size_t i = first; i < path.size(); i++) at.push_back(ws.getDist(path[i]));
+    return ws.getDist(t);
+}
+
+Generator<RankedRoute> kShortestPaths(const CsrGraph &graph, int source, int destination,
+                                      vector<int> avoidNodes, vector<pair<int, int>> avoidSegments,
+                                      ThreadPool *pool) {
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    if (s == -1 || t == -1 || s == t) co_return;
+
+    vector<char> blockedNodes, blockedEdges;
+    buildAvoidMasks(graph, avoidNodes, avoidSegments, blockedNodes, blockedEdges);
+    if (blockedNodes[s] || blockedNodes[t]) co_return;
+
+    SearchWorkspace reverseWs;
+    reverseDrivingTree(graph, t, blockedNodes, blockedEdges, reverseWs);
+    if (reverseWs.getDist(s) == INF) co_return;
+
+    auto toRoute = [&](const SpurCandidate &candidate) {
+        RankedRoute route{{}, candidate.time};
+        for (int v : candidate.path) route.path.push_back(graph.getId(v));
+        return route;
+    };
+
+    // Routes handed out so far, then the candidates; seen holds the paths of both
+    vector<SpurCandidate> found;
+    vector<SpurCandidate> candidates;
+    set<vector<int>> seen;
+    // (time, 0 if resolved, candidate): exact routes go first on equal times
+    priority_queue<tuple<double, int, int>, vector<tuple<double, int, int>>, greater<>> pending;
+
+    SpurCandidate best{reverseWs.getDist(s), -1, -1, true};
+    for (int v = s; v != -1; v = reverseWs.getParent(v)) {
+        best.path.push_back(v);
+        best.at.push_back(reverseWs.getDist(s) - reverseWs.getDist(v));
+    }
+    seen.insert(best.path);
+    found.push_back(std::move(best));
+    co_yield toRoute(found.back());
+
+    unsigned numWorkers = pool ? pool->size() : 1;
+    vector<SearchWorkspace> workspaces(numWorkers);
+    vector<vector<char>> onRoot(numWorkers, vector<char>(graph.getNumVertex(), 0));
+
+    // Spur search of one candidate against every route found so far
+    auto resolve = [&](SpurCandidate &candidate, unsigned worker) {
+        const SpurCandidate &base = found[candidate.base];
+        int i = candidate.spurIndex;
+        vector<int> forbiddenNext;
+        for (const SpurCandidate &route : found) {
+            if ((int) route.path.size() > i + 1
+                && equal(route.path.begin(), route.path.begin() + i + 1, base.path.begin())) {
+                forbiddenNext.push_back(route.path[i + 1]);
+            }
+        }
+
+        vector<char> &root = onRoot[worker];
+        for (int k = 0; k < i; k++) root[base.path[k]] = 1;
+        candidate.path.assign(base.path.begin(), base.path.begin() + i + 1);
+        candidate.at.assign(base.at.begin(), base.at.begin() + i + 1);
+        size_t spurEnd = candidate.at.size();
+        double spurTime = searchSpur(graph, base.path[i], t, blockedNodes, blockedEdges, root, forbiddenNext,
+                                     reverseWs, workspaces[worker], candidate.path, candidate.at);
+        for (int k = 0; k < i; k++) root[base.path[k]] = 0;
+
+        for (size_t k = spurEnd; k < candidate.at.size(); k++) candidate.at[k] += base.at[i];
+        candidate.time = base.at[i] + spurTime;
+        candidate.resolved = true;
+    };
+
+    while (true) {
+        // Spurs of the route just handed out, each bounded below by the shared tree
+        const SpurCandidate &last = found.back();
+        for (size_t i = 0; i + 1 < last.path.size(); i++) {
+            double rest = reverseWs.getDist(last.path[i]);
+            if (rest == INF) continue;
+            candidates.push_back({last.at[i] + rest, (int) found.size() - 1, (int) i});
+            pending.emplace(candidates.back().time, 1, candidates.size() - 1);
+        }
+
+        // Search the cheapest spurs until an exact route is cheapest
+        while (!pending.empty() && get<1>(pending.top()) == 1) {
+            vector<int> batch;
+            while (batch.size() < numWorkers && !pending.empty() && get<1>(pending.top()) == 1) {
+                batch.push_back(get<2>(pending.top()));
+                pending.pop();
+            }
+            if (pool && batch.size() > 1) {
+                pool->parallelFor(batch.size(), [&](int i, unsigned worker) { resolve(candidates[batch[i]], worker); });
+            } else {
+                for (int id : batch) resolve(candidates[id], 0);
+            }
+
+            for (int id : batch) {
+                SpurCandidate &candidate = candidates[id];
+                if (candidate.time == INF || !seen.insert(candidate.path).second) {
+                    candidate.path.clear();
+                    candidate.at.clear();
+                    continue;
+                }
+                pending.emplace(candidate.time, 0, id);
+            }
+        }
+        if (pending.empty()) co_return;
+
+        int next = get<2>(pending.top());
+        pending.pop();
+        found.push_back(std::move(candidates[next]));
+        co_yield toRoute(found.back());
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef K_SHORTEST_PATHS_H
+#define K_SHORTEST_PATHS_H
+
+#include <vector>
+#include <utility>
+#include "data_structures/CsrGraph.h"
+#include "data_structures/Generator.h"
+#include "data_structures/ThreadPool.h"
+
+struct RankedRoute {
+    std::vector<int> path;   // CSV Ids, source ... destination
+    double time = 0;
+};
+
+/**
+ * Loopless driving routes from source to destination by increasing time (Yen's algorithm),
+ * produced on demand: the first route comes straight from one driving tree grown backwards
+ * from the destination, and each later one is only computed when the consumer asks for it.
+ *
+ * The backward tree is shared by every spur search. Its distances give each spur an
+ * admissible lower bound, so a spur is only searched once it could hold the next route.
+ * When the tree's own path from the spur node is still allowed, the search is skipped
+ * altogether; otherwise it runs A* with the tree distances as the heuristic. Spur searches
+ * that become due together run on pool (sequentially without one) with their own workspaces.
+ *
+ * Avoided nodes and segments are masked as in restrictedDrivingRoute. graph and pool must
+ * outlive the generator; the search state lives in its coroutine frame, so other queries may
+ * run on the same thread between two routes.
+ */
+Generator<RankedRoute> kShortestPaths(
+        const CsrGraph &graph,
+        int source,
+        int destination,
+        std::vector<int> avoidNodes = {},
+        std::vector<std::pair<int, int>> avoidSegments = {},
+        ThreadPool *pool = nullptr
+);
+
+#endif // K_SHORTEST_PATHS_H
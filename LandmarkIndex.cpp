@@ -0,0 +1,356 @@
+#include "LandmarkIndex.h"
+#include "BestRoute.h"
+#include "RestrictedRoute.h"
+#include "data_structures/SearchQueue.h"
+#include "data_structures/ThreadPool.h"
+#include <queue>
+#include <tuple>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+
+/*
+ * One-to-all Dijkstra from root, over outgoing edges or (backward) incoming edges.
+ */
+void landmarkSearch(const CsrGraph &graph, int root, bool useDriving, bool backward, SearchWorkspace &ws) {
+    ws.reset(graph.getNumVertex());
+    ws.setDist(root, 0);
+    withSearchQueue(graph, [&](auto makeQueue) {
+        auto q = makeQueue(ws);
+        q.insert(root);
+
+        while (!q.empty()) {
+            int v = q.extractMin();
+            double d = ws.getDist(v);
+            int begin = backward ? graph.inEdgeBegin(v) : graph.edgeBegin(v);
+            int end = backward ? graph.inEdgeEnd(v) : graph.edgeEnd(v);
+            for (int k = begin; k < end; k++) {
+                int e = backward ? graph.getInEdge(k) : k;
+                int w = backward ? graph.getInSource(k) : graph.getTarget(e);
+                double weight = useDriving ? graph.getDrivingWeight(e) : graph.getWalkingWeight(e);
+                if (weight == INF) continue;
+
+                auto oldDist = ws.getDist(w);
+                if (d + weight < oldDist) {
+                    ws.setDist(w, d + weight);
+                    ws.setParent(w, v);
+                    if (oldDist == INF) q.insert(w);
+                    else q.decreaseKey(w);
+                }
+            }
+        }
+    });
+}
+
+/*
+ * max(a - b, c - d) over the landmark rows, ignoring terms with an unreachable side.
+ */
+inline double triangleBound(const double *fromV, const double *toV, const double *fromT, const double *toT, int k) {
+    double bound = 0;
+    for (int i = 0; i < k; i++) {
+        if (fromT[i] != INF && fromV[i] != INF) bound = max(bound, fromT[i] - fromV[i]);
+        if (toV[i] != INF && toT[i] != INF) bound = max(bound, toV[i] - toT[i]);
+    }
+    return bound;
+}
+
+LandmarkIndex::LandmarkIndex(const CsrGraph &graph, int numLandmarks, LandmarkSelection selection, unsigned numThreads)
+        : graph(graph) {
+    numLandmarks = min(numLandmarks, graph.getNumVertex());
+    if (numLandmarks > 0) {
+        if (selection == LandmarkSelection::Farthest) selectFarthest(numLandmarks);
+        else selectAvoid(numLandmarks);
+    }
+    k = landmarks.size();
+    computeTables(numThreads);
+}
+
+void LandmarkIndex::selectFarthest(int numLandmarks) {
+    int n = graph.getNumVertex();
+    SearchWorkspace ws(n);
+    vector<double> minDist(n, INF);
+
+    // Start from the vertex farthest from an arbitrary one
+    landmarkSearch(graph, 0, true, false, ws);
+    int next = 0;
+    for (int v = 0; v < n; v++)
+        if (ws.getDist(v) != INF && ws.getDist(v) > ws.getDist(next)) next = v;
+
+    while ((int) landmarks.size() < numLandmarks) {
+        landmarks.push_back(next);
+        landmarkSearch(graph, next, true, false, ws);
+        for (int v = 0; v < n; v++) minDist[v] = min(minDist[v], ws.getDist(v));
+
+        next = -1;
+        for (int v = 0; v < n; v++) {
+            if (minDist[v] == INF || minDist[v] == 0) continue;
+            if (next == -1 || minDist[v] > minDist[next]) next = v;
+        }
+        if (next == -1) break; // every reachable vertex is already a landmark
+    }
+}
+
+void LandmarkIndex::selectAvoid(int numLandmarks) {
+    int n = graph.getNumVertex();
+    SearchWorkspace ws(n), scratch(n);
+    mt19937 rng(20250323);
+    vector<vector<double>> from, to; // driving tables of the landmarks picked so far
+    vector<char> isLandmark(n, 0), covered(n);
+    vector<int> order, childCount(n), childStart(n + 1), children(n);
+    vector<double> size(n);
+
+    for (int attempt = 0; (int) landmarks.size() < numLandmarks && attempt < 4 * numLandmarks; attempt++) {
+        int r = rng() % n;
+        landmarkSearch(graph, r, true, false, ws);
+
+        // Children lists of the shortest-path tree rooted at r
+        fill(childCount.begin(), childCount.end(), 0);
+        for (int v = 0; v < n; v++)
+            if (ws.getParent(v) != -1) childCount[ws.getParent(v)]++;
+        childStart[0] = 0;
+        for (int v = 0; v < n; v++) childStart[v + 1] = childStart[v] + childCount[v];
+        fill(childCount.begin(), childCount.end(), 0);
+        for (int v = 0; v < n; v++) {
+            int p = ws.getParent(v);
+            if (p != -1) children[childStart[p] + childCount[p]++] = v;
+        }
+
+        // Top-down order, so the reverse visits children before parents
+        order.assign(1, r);
+        for (size_t i = 0; i < order.size(); i++)
+            for (int c = childStart[order[i]]; c < childStart[order[i] + 1]; c++) order.push_back(children[c]);
+
+        // size = total gap between d(r, v) and its current lower bound over the subtree,
+        // or 0 if the subtree already holds a landmark
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            int v = *it;
+            double bound = 0;
+            for (size_t i = 0; i < from.size(); i++) {
+                if (from[i][v] != INF && from[i][r] != INF) bound = max(bound, from[i][v] - from[i][r]);
+                if (to[i][r] != INF && to[i][v] != INF) bound = max(bound, to[i][r] - to[i][v]);
+            }
+            size[v] = ws.getDist(v) - bound;
+            covered[v] = isLandmark[v];
+            for (int c = childStart[v]; c < childStart[v + 1]; c++) {
+                size[v] += size[children[c]];
+                covered[v] |= covered[children[c]];
+            }
+        }
+        int w = r;
+        for (int v : order) {
+            if (covered[v]) size[v] = 0;
+            if (size[v] > size[w]) w = v;
+        }
+        if (size[w] <= 0) continue;
+
+        // Walk down the heaviest branch from the heaviest uncovered subtree to a leaf
+        while (true) {
+            int best = -1;
+            for (int c = childStart[w]; c < childStart[w + 1]; c++)
+                if (size[children[c]] > 0 && (best == -1 || size[children[c]] > size[best])) best = children[c];
+            if (best == -1) break;
+            w = best;
+        }
+        if (isLandmark[w]) continue;
+
+        isLandmark[w] = 1;
+        landmarks.push_back(w);
+        landmarkSearch(graph, w, true, false, scratch);
+        from.emplace_back(n);
+        for (int v = 0; v < n; v++) from.back()[v] = scratch.getDist(v);
+        landmarkSearch(graph, w, true, true, scratch);
+        to.emplace_back(n);
+        for (int v = 0; v < n; v++) to.back()[v] = scratch.getDist(v);
+    }
+}
+
+void LandmarkIndex::computeTables(unsigned numThreads) {
+    int n = graph.getNumVertex();
+    drivingFrom.assign((size_t) n * k, INF);
+    drivingTo.assign((size_t) n * k, INF);
+    walkingFrom.assign((size_t) n * k, INF);
+    walkingTo.assign((size_t) n * k, INF);
+    if (k == 0) return;
+
+    ThreadPool pool(numThreads);
+    vector<SearchWorkspace> workspaces(pool.size());
+    // task = 4 * landmark + (driving?, backward?)
+    pool.parallelFor(4 * k, [&](int task, unsigned worker) {
+        int i = task / 4;
+        bool useDriving = (task & 2) == 0;
+        bool backward = (task & 1) != 0;
+        auto &table = useDriving ? (backward ? drivingTo : drivingFrom) : (backward ? walkingTo : walkingFrom);
+        landmarkSearch(graph, landmarks[i], useDriving, backward, workspaces[worker]);
+        for (int v = 0; v < n; v++) table[(size_t) v * k + i] = workspaces[worker].getDist(v);
+    });
+}
+
+const vector<int> &LandmarkIndex::getLandmarks() const {
+    return landmarks;
+}
+
+double LandmarkIndex::drivingLowerBound(int v, int t) const {
+    return triangleBound(&drivingFrom[(size_t) v * k], &drivingTo[(size_t) v * k],
+                         &drivingFrom[(size_t) t * k], &drivingTo[(size_t) t * k], k);
+}
+
+double LandmarkIndex::walkingLowerBound(int v, int t) const {
+    return triangleBound(&walkingFrom[(size_t) v * k], &walkingTo[(size_t) v * k],
+                         &walkingFrom[(size_t) t * k], &walkingTo[(size_t) t * k], k);
+}
+
+double LandmarkIndex::aStar(int s, int t, const vector<char> &blockedNodes, const vector<char> &blockedEdges,
+                            SearchWorkspace &ws) const {
+    auto isBlocked = [&](int v) { return !blockedNodes.empty() && blockedNodes[v] && v != s; };
+    ws.reset(graph.getNumVertex());
+    if (isBlocked(t)) return INF;
+
+    // (f = g + h, g, vertex); an entry is stale once a shorter g was recorded for its vertex
+    priority_queue<tuple<double, double, int>, vector<tuple<double, double, int>>, greater<>> pq;
+    ws.setDist(s, 0);
+    pq.emplace(drivingLowerBound(s, t), 0, s);
+
+    while (!pq.empty()) {
+        auto [f, g, v] = pq.top(); pq.pop();
+        if (g > ws.getDist(v)) continue;
+        if (v == t) return g;
+
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+            int w = graph.getTarget(e);
+            if (isBlocked(w)) continue;
+            if (!blockedEdges.empty() && blockedEdges[e]) continue;
+            double weight = graph.getDrivingWeight(e);
+            if (weight == INF) continue;
+
+            if (g + weight < ws.getDist(w)) {
+                ws.setDist(w, g + weight);
+                ws.setParent(w, v);
+                pq.emplace(g + weight + drivingLowerBound(w, t), g + weight, w);
+            }
+        }
+    }
+    return INF;
+}
+
+vector<int> LandmarkIndex::findBestRoute(int source, int destination, double &totalTime, SearchWorkspace &ws) const {
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    if (s == -1 || t == -1) return {};
+
+    double dist = aStar(s, t, {}, {}, ws);
+    if (dist == INF) return {};
+    totalTime = dist;
+    return buildCsrPath(graph, ws, t);
+}
+
+vector<int> LandmarkIndex::restrictedDrivingRoute(int source, int destination, const vector<int> &avoidNodes,
+                                                  const vector<pair<int, int>> &avoidSegments, int includeNode,
+                                                  SearchWorkspace &ws) const {
+    vector<int> includeNodes;
+    if (includeNode != -1) includeNodes.push_back(includeNode);
+    return waypointDrivingRoute(source, destination, includeNodes, avoidNodes, avoidSegments, ws);
+}
+
+vector<int> LandmarkIndex::waypointDrivingRoute(int source, int destination, const vector<int> &includeNodes,
+                                                const vector<int> &avoidNodes,
+                                                const vector<pair<int, int>> &avoidSegments,
+                                                SearchWorkspace &ws) const {
+    auto stops = waypointStops(graph, source, destination, includeNodes);
+    if (stops.empty()) return {};
+    if (stops.size() == 1) return {graph.getId(stops[0])};
+
+    vector<char> blockedNodes, blockedEdges;
+    buildAvoidMasks(graph, avoidNodes, avoidSegments, blockedNodes, blockedEdges);
+
+    vector<int> path;
+    for (size_t i = 0; i + 1 < stops.size(); i++) {
+        if (aStar(stops[i], stops[i + 1], blockedNodes, blockedEdges, ws) == INF) return {};
+        if (!path.empty()) path.pop_back(); // the leg starts with the stop the last one ended at
+        appendCsrPath(graph, ws, stops[i + 1], path);
+    }
+    return path;
+}
+
+EnvFriendlyRoute LandmarkIndex::findEnvFriendlyRoute(int source, int destination, double maxWalk,
+                                                     const vector<int> &avoidNodes,
+                                                     const vector<pair<int, int>> &avoidSegments,
+                                                     SearchWorkspace &driveWs, SearchWorkspace &walkWs) const {
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    vector<char> blockedNodes, blockedEdges;
+    buildAvoidMasks(graph, avoidNodes, avoidSegments, blockedNodes, blockedEdges);
+
+    // 1. Walking search from the destination, cut off at the walking budget
+    auto candidates = findWalkableParking(graph, s, t, maxWalk, blockedNodes, blockedEdges, walkWs);
+
+    // 2. Driving A* from the source towards all candidates at once:
+    //    h(v) = min over candidates p of (lower bound d(v, p) + walk(p, destination))
+    auto heuristic = [&](int v) {
+        double h = INF;
+        for (int p : candidates) h = min(h, drivingLowerBound(v, p) + walkWs.getDist(p));
+        return h;
+    };
+    vector<tuple<double, double, int>> found; // (total, walk, parking)
+    double secondBest = INF;
+    bool anyParking = false;
+    driveWs.reset(graph.getNumVertex());
+    if (s != -1 && !blockedNodes[s]) {
+        priority_queue<tuple<double, double, int>, vector<tuple<double, double, int>>, greater<>> pq;
+        driveWs.setDist(s, 0);
+        pq.emplace(candidates.empty() ? 0 : heuristic(s), 0, s);
+        while (!pq.empty()) {
+            auto [f, g, v] = pq.top(); pq.pop();
+            if (g > driveWs.getDist(v)) continue;
+            if (f > secondBest) break; // nothing left can enter the top two (ties included)
+
+            if (v != s && graph.getParking(v)) {
+                anyParking = true;
+                if (candidates.empty()) break; // only needed to explain the failure
+                if (walkWs.getDist(v) <= maxWalk && v != t) {
+                    found.emplace_back(g + walkWs.getDist(v), walkWs.getDist(v), v);
+                    if (found.size() == candidates.size()) break;
+                    if (found.size() >= 2) {
+                        vector<double> totals;
+                        for (auto &[total, walk, p] : found) totals.push_back(total);
+                        nth_element(totals.begin(), totals.begin() + 1, totals.end());
+                        secondBest = totals[1];
+                    }
+                }
+            }
+
+            for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+                int w = graph.getTarget(e);
+                if (blockedNodes[w] || blockedEdges[e]) continue;
+                double weight = graph.getDrivingWeight(e);
+                if (weight == INF) continue;
+                if (g + weight < driveWs.getDist(w)) {
+                    driveWs.setDist(w, g + weight);
+                    driveWs.setParent(w, v);
+                    pq.emplace(g + weight + (candidates.empty() ? 0 : heuristic(w)), g + weight, w);
+                }
+            }
+        }
+    }
+
+    if (found.empty()) {
+        return EnvFriendlyRoute{-1, 0, 0, 0, {}, {}, envFailureMessage(anyParking)};
+    }
+
+    // Same ordering as findEnvFriendlyRoute: total time, then more walking first
+    sort(found.begin(), found.end(), [](const auto &a, const auto &b) {
+        if (get<0>(a) != get<0>(b)) return get<0>(a) < get<0>(b);
+        return get<1>(a) > get<1>(b);
+    });
+
+    vector<EnvFriendlyRoute> routes;
+    for (size_t i = 0; i < found.size() && i < 2; i++) {
+        auto [total, walk, p] = found[i];
+        auto walkPath = buildCsrPath(graph, walkWs, p);
+        reverse(walkPath.begin(), walkPath.end());
+        routes.push_back({graph.getId(p), driveWs.getDist(p), walk, total, buildCsrPath(graph, driveWs, p), walkPath});
+    }
+    EnvFriendlyRoute best = routes[0];
+    if (routes.size() > 1) best.alternatives.push_back(routes[1]);
+    return best;
+}
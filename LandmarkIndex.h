@@ -0,0 +1,87 @@
+#ifndef LANDMARK_INDEX_H
+#define LANDMARK_INDEX_H
+
+#include <vector>
+#include <utility>
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
+#include "EnvFriendlyRoute.h"
+
+enum class LandmarkSelection {
+    Farthest, // repeatedly take the vertex farthest from the landmarks chosen so far
+    Avoid     // Goldberg-Werneck "avoid": grow landmarks where the current bounds are weakest
+};
+
+/**
+ * ALT (A*, Landmarks, Triangle inequality) goal-directed search over a CSR snapshot.
+ *
+ * For every landmark L the index stores d(L, v) and d(v, L) for all v, for both driving and
+ * walking weights. By the triangle inequality
+ *     d(v, t) >= max(d(L, t) - d(L, v), d(v, L) - d(t, L))
+ * which gives A* a consistent lower bound. Removing nodes or segments at query time only makes
+ * distances longer, so the same bounds stay valid for restricted queries.
+ */
+class LandmarkIndex {
+public:
+    /*
+     * Selects numLandmarks landmarks and precomputes their distance tables, one landmark
+     * per task on numThreads workers (0 = one per hardware thread).
+     * The snapshot must outlive the index.
+     */
+    explicit LandmarkIndex(const CsrGraph &graph, int numLandmarks = 8,
+                           LandmarkSelection selection = LandmarkSelection::Avoid, unsigned numThreads = 0);
+
+    const std::vector<int> &getLandmarks() const;
+
+    /*
+     * Lower bounds on the driving / walking distance between dense indices v and t.
+     */
+    double drivingLowerBound(int v, int t) const;
+    double walkingLowerBound(int v, int t) const;
+
+    /*
+     * Same contracts as the CsrGraph route functions, answered with A*.
+     */
+    std::vector<int> findBestRoute(int source, int destination, double &totalTime,
+                                   SearchWorkspace &ws = SearchWorkspace::forThread(0)) const;
+    std::vector<int> restrictedDrivingRoute(int source, int destination,
+                                            const std::vector<int> &avoidNodes,
+                                            const std::vector<std::pair<int, int>> &avoidSegments,
+                                            int includeNode,
+                                            SearchWorkspace &ws = SearchWorkspace::forThread(0)) const;
+    std::vector<int> waypointDrivingRoute(int source, int destination,
+                                          const std::vector<int> &includeNodes,
+                                          const std::vector<int> &avoidNodes,
+                                          const std::vector<std::pair<int, int>> &avoidSegments,
+                                          SearchWorkspace &ws = SearchWorkspace::forThread(0)) const;
+
+    /*
+     * Env route: a walking search from the destination bounded by maxWalkTime finds the usable
+     * parking nodes, then one driving A* towards all of them (bounded by the cheapest
+     * "lower bound to parking + walk" over the candidates) settles them in order of total time.
+     */
+    EnvFriendlyRoute findEnvFriendlyRoute(int source, int destination, double maxWalkTime,
+                                          const std::vector<int> &avoidNodes,
+                                          const std::vector<std::pair<int, int>> &avoidSegments,
+                                          SearchWorkspace &driveWs = SearchWorkspace::forThread(0),
+                                          SearchWorkspace &walkWs = SearchWorkspace::forThread(1)) const;
+
+protected:
+    const CsrGraph &graph;
+    int k = 0;
+    std::vector<int> landmarks;
+    // row-major n x k tables: entry v * k + i belongs to vertex v and landmark i
+    std::vector<double> drivingFrom, drivingTo, walkingFrom, walkingTo;
+
+    void selectFarthest(int numLandmarks);
+    void selectAvoid(int numLandmarks);
+    void computeTables(unsigned numThreads);
+
+    /*
+     * A* from s to t skipping masked nodes and edges; the search tree is left in ws.
+     */
+    double aStar(int s, int t, const std::vector<char> &blockedNodes, const std::vector<char> &blockedEdges,
+                 SearchWorkspace &ws) const;
+};
+
+#endif // LANDMARK_INDEX_H
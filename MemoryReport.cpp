@@ -0,0 +1,24 @@
+#include "MemoryReport.h"
+#include "data_structures/SearchWorkspace.h"
+#include <iomanip>
+#include <string>
+
+using namespace std;
+
+void writeMemoryReport(const Graph<int> *graph, const CsrGraph &csr, const DistanceTable *table, ostream &out) {
+    int n = csr.getNumVertex(), m = csr.getNumEdges();
+    auto report = [&](const string &name, size_t bytes) {
+        out << left << setw(30) << name << right << fixed << setprecision(2)
+            << setw(10) << bytes / (1024.0 * 1024.0) << " MiB"
+            << setw(10) << (n ? (double) bytes / n : 0.0) << " B/V"
+            << setw(10) << (m ? (double) bytes / m : 0.0) << " B/E\n";
+    };
+
+    out << "Memory for " << n << " vertices and " << m << " edges\n";
+    if (graph) report("Graph<int> (editable)", graph->getSizeBytes());
+    report("CSR search arrays", csr.getSearchBytes());
+    report("CSR metadata", csr.getMetadataBytes());
+    SearchWorkspace ws(n);
+    report("Search workspace (each)", ws.getSizeBytes());
+    if (table) report(table->isMapped() ? "Distance table (mapped)" : "Distance table", table->getSizeBytes());
+}
@@ -0,0 +1,16 @@
+#ifndef MEMORY_REPORT_H
+#define MEMORY_REPORT_H
+
+#include <iostream>
+#include "data_structures/Graph.h"
+#include "data_structures/CsrGraph.h"
+#include "DistanceTable.h"
+
+/**
+ * Writes the memory held by each representation of the loaded data, in total and per vertex
+ * and per edge: the editable Graph<int> (if given), the CSR arrays searches read, the CSR
+ * metadata (Ids, parking, names), one search workspace, and the distance table (if given).
+ */
+void writeMemoryReport(const Graph<int> *graph, const CsrGraph &csr, const DistanceTable *table, std::ostream &out);
+
+#endif // MEMORY_REPORT_H
@@ -0,0 +1,182 @@
+#include "MultimodalRoute.h"
+#include "RestrictedRoute.h"
+#include <queue>
+#include <unordered_map>
+#include <tuple>
+#include <algorithm>
+
+using namespace std;
+
+struct MultimodalLabel {
+    double total;
+    double walk;    // walking time spent so far (the budgeted resource)
+    int vertex;
+    int parent;     // label this one was extended from, -1 at the source
+    TravelMode mode;
+};
+
+/*
+ * Walking labels settled at one vertex. Labels are settled by increasing total, so a new one
+ * is dominated exactly when an earlier label with a strictly smaller total walked no more.
+ */
+struct WalkingFront {
+    double total = -1;           // total of the labels settled last
+    double walkAtTotal = INF;    // smallest walk among them
+    double walkBefore = INF;     // smallest walk among labels with a smaller total
+
+    // Smallest walk a label with the given total has to beat
+    double bound(double labelTotal) const {
+        return labelTotal > total ? min(walkBefore, walkAtTotal) : walkBefore;
+    }
+};
+
+/*
+ * Edge weight of an edge in the given layer (INF if the mode cannot use it)
+ */
+double multimodalWeight(const CsrGraph& graph, TravelMode mode, int e) {
+    return mode == TravelMode::Driving ? graph.getDrivingWeight(e) : graph.getWalkingWeight(e);
+}
+
+/*
+ * Vertices (CSV Ids) of the labels from id back to the first one of the same mode.
+ * Returns the id of the label the leg was extended from.
+ */
+int collectMultimodalLeg(const CsrGraph& graph, const vector<MultimodalLabel>& labels, int id, vector<int>& leg) {
+    TravelMode mode = labels[id].mode;
+    for (; id != -1 && labels[id].mode == mode; id = labels[id].parent) {
+        leg.push_back(graph.getId(labels[id].vertex));
+    }
+    return id;
+}
+
+EnvFriendlyRoute findMultimodalRoute(
+        const CsrGraph& graph,
+        int source,
+        int destination,
+        double maxWalk,
+        const vector<int>& avoidNodes,
+        const vector<pair<int, int>>& avoidSegments,
+        const LandmarkIndex* landmarks,
+        SearchWorkspace& driveWs) {
+
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    vector<char> blockedNodes, blockedEdges;
+    buildAvoidMasks(graph, avoidNodes, avoidSegments, blockedNodes, blockedEdges);
+
+    // Driving layer: best time per vertex, parent = id of the label holding it.
+    // Walking layer: the settled front per vertex (only vertices within the budget are met).
+    driveWs.reset(graph.getNumVertex());
+    unordered_map<int, WalkingFront> walkingFronts;
+
+    bool anyParking = false;
+    bool destinationOpen = t != -1 && !blockedNodes[t];
+
+    // Lower bound on the walk left from v: consistent, and 0 at the destination, so every
+    // vertex still settles its labels by total. Driving labels use 0 (the park transition is free).
+    auto restOfWalk = [&](int v) {
+        return landmarks && destinationOpen ? landmarks->walkingLowerBound(t, v) : 0.0;
+    };
+
+    // Parking nodes the walking layer could still start from. Once the car has been left at all
+    // of them, driving labels are only settled until the first parking node (for the message).
+    int openParking = 0;
+    if (destinationOpen) {
+        for (int p : graph.getParkingVertices()) {
+            if (p != s && p != t && !blockedNodes[p] && restOfWalk(p) <= maxWalk) openParking++;
+        }
+    }
+
+    vector<MultimodalLabel> labels;
+    // (key, total, -walk, label): smallest key first, then smallest total, then more walking
+    priority_queue<tuple<double, double, double, int>, vector<tuple<double, double, double, int>>, greater<>> pq;
+    auto push = [&](double total, double walk, int vertex, int parent, TravelMode mode, double rest) {
+        labels.push_back({total, walk, vertex, parent, mode});
+        pq.emplace(total + rest, total, -walk, labels.size() - 1);
+        return (int) labels.size() - 1;
+    };
+    int found = -1;
+    if (s != -1 && !blockedNodes[s]) {
+        driveWs.setDist(s, 0);
+        driveWs.setParent(s, push(0, 0, s, -1, TravelMode::Driving, 0));
+    }
+
+    while (!pq.empty()) {
+        int id = get<3>(pq.top()); pq.pop();
+        MultimodalLabel label = labels[id];
+        int v = label.vertex;
+
+        if (label.mode == TravelMode::Driving) {
+            if (driveWs.getParent(v) != id) continue; // a faster drive to v was found later
+
+            // Transition: leave the car here
+            if (v != s && graph.getParking(v)) {
+                anyParking = true;
+                double rest = restOfWalk(v);
+                if (v != t && destinationOpen && rest <= maxWalk) {
+                    push(label.total, 0, v, id, TravelMode::Walking, rest);
+                    openParking--;
+                }
+            }
+            if (openParking == 0 && anyParking) continue;
+        } else {
+            WalkingFront& front = walkingFronts[v];
+            if (label.total > front.total) {
+                front.walkBefore = min(front.walkBefore, front.walkAtTotal);
+                front.total = label.total;
+                front.walkAtTotal = INF;
+            }
+            // Dominated, or the same (total, walk) as a label already settled here
+            if (label.walk >= front.walkBefore || label.walk == front.walkAtTotal) continue;
+            front.walkAtTotal = label.walk;
+
+            if (v == t) {
+                found = id;
+                break;
+            }
+        }
+
+        // Walking legs run towards the destination over incoming edges, so they follow the
+        // destination-rooted walking trees of findEnvFriendlyRoute
+        bool walking = label.mode == TravelMode::Walking;
+        int begin = walking ? graph.inEdgeBegin(v) : graph.edgeBegin(v);
+        int end = walking ? graph.inEdgeEnd(v) : graph.edgeEnd(v);
+        for (int k = begin; k < end; k++) {
+            int w = walking ? graph.getInSource(k) : graph.getTarget(k);
+            int e = walking ? graph.getInEdge(k) : k;
+            if (blockedNodes[w] || blockedEdges[e]) continue;
+            double weight = multimodalWeight(graph, label.mode, e);
+            if (weight == INF) continue;
+            double total = label.total + weight;
+
+            if (!walking) {
+                if (total < driveWs.getDist(w)) {
+                    driveWs.setDist(w, total);
+                    driveWs.setParent(w, push(total, 0, w, id, TravelMode::Driving, 0));
+                }
+                continue;
+            }
+
+            double walk = label.walk + weight;
+            double rest = restOfWalk(w);
+            if (walk + rest > maxWalk) continue;
+            auto it = walkingFronts.find(w);
+            if (it != walkingFronts.end() && walk >= it->second.bound(total)) continue;
+            push(total, walk, w, id, TravelMode::Walking, rest);
+        }
+    }
+
+    if (found == -1) {
+        return EnvFriendlyRoute{-1, 0, 0, 0, {}, {}, envFailureMessage(anyParking)};
+    }
+
+    const MultimodalLabel& label = labels[found];
+    vector<int> walkingPath, drivingPath;
+    int carLabel = collectMultimodalLeg(graph, labels, found, walkingPath);  // destination ... parking
+    collectMultimodalLeg(graph, labels, carLabel, drivingPath);             // parking ... source
+    reverse(drivingPath.begin(), drivingPath.end());
+    reverse(walkingPath.begin(), walkingPath.end());
+
+    return EnvFriendlyRoute{walkingPath.front(), labels[carLabel].total, label.walk, label.total,
+                            drivingPath, walkingPath, ""};
+}
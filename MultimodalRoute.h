@@ -0,0 +1,51 @@
+#ifndef MULTIMODAL_ROUTE_H
+#define MULTIMODAL_ROUTE_H
+
+#include <vector>
+#include <utility>
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
+#include "EnvFriendlyRoute.h"
+#include "LandmarkIndex.h"
+
+/**
+ * Layers of the multimodal state graph. Every layer is a copy of the road graph travelled with
+ * its own weights; a trip moves between layers only through mode transitions (for now: leaving
+ * the car at a parking node). A new mode gets a layer here, its edge weights and budget in
+ * MultimodalRoute.cpp, and the transitions into and out of it.
+ */
+enum class TravelMode { Driving, Walking };
+
+/**
+ * Driving + walking trip answered by a single search over the layered state graph
+ * (vertex, mode), instead of a walking search from the destination, a driving search from the
+ * source and a join over their parking nodes.
+ *
+ * The search starts at (source, Driving). At every parking node other than source and
+ * destination the car can be left, which moves the trip to (node, Walking) at no cost. Walking
+ * labels carry the walking time spent so far as a resource, are dropped once it exceeds
+ * maxWalkTime and are kept per vertex only while no label with a smaller total walks as little.
+ * Labels are settled by total time, with more walking first on ties, so the first label settled
+ * at (destination, Walking) is the route findEnvFriendlyRoute returns and the search stops there.
+ *
+ * Walking runs over incoming edges, like the destination-rooted walking trees of
+ * findEnvFriendlyRoute. The result carries no alternatives; on failure its message is the one
+ * findEnvFriendlyRoute gives. driveWs holds the driving layer (best time and label per vertex).
+ *
+ * With landmarks, walking labels are keyed by total + a lower bound on the rest of the walk
+ * (A* on the walking layer), and labels that cannot reach the destination within the budget
+ * are dropped early; without them the walking layer spreads over the whole budget around every
+ * parking node settled before the answer.
+ */
+EnvFriendlyRoute findMultimodalRoute(
+        const CsrGraph& graph,
+        int source,
+        int destination,
+        double maxWalkTime,
+        const std::vector<int>& avoidNodes,
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        const LandmarkIndex* landmarks = nullptr,
+        SearchWorkspace& driveWs = SearchWorkspace::forThread(0)
+);
+
+#endif // MULTIMODAL_ROUTE_H
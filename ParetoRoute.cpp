@@ -0,0 +1,143 @@
+#include "ParetoRoute.h"
+#include "RestrictedRoute.h"
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <tuple>
+#include <algorithm>
+
+using namespace std;
+
+struct ParetoLabel {
+    double total;
+    double walk;
+    int vertex;
+    int parent;   // label this one was extended from, -1 at the source
+    bool walking; // false while still in the car
+};
+
+/*
+ * Vertices (CSV Ids) of the labels from id back to the first one of the same leg.
+ * Returns the id of the label the leg was extended from.
+ */
+int collectParetoLeg(const CsrGraph& graph, const vector<ParetoLabel>& labels, int id, vector<int>& leg) {
+    bool walking = labels[id].walking;
+    for (; id != -1 && labels[id].walking == walking; id = labels[id].parent) {
+        leg.push_back(graph.getId(labels[id].vertex));
+    }
+    return id;
+}
+
+vector<EnvFriendlyRoute> findParetoEnvRoutes(
+        const CsrGraph& graph,
+        int source,
+        int destination,
+        double maxWalk,
+        const vector<int>& avoidNodes,
+        const vector<pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs,
+        SearchWorkspace& walkWs) {
+
+    vector<EnvFriendlyRoute> front;
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    if (s == -1 || t == -1 || s == t) return front;
+
+    vector<char> blockedNodes, blockedEdges;
+    buildAvoidMasks(graph, avoidNodes, avoidSegments, blockedNodes, blockedEdges);
+    if (blockedNodes[s] || blockedNodes[t]) return front;
+
+    // walkWs: exact walking time to the destination inside the maxWalk radius, a lower bound
+    // for the rest of any walking leg (vertices outside the radius cannot be walked through)
+    auto candidates = findWalkableParking(graph, s, t, maxWalk, blockedNodes, blockedEdges, walkWs);
+    if (candidates.empty()) return front;
+    unordered_set<int> unsettledCandidates(candidates.begin(), candidates.end());
+
+    // driveWs: best driving time per vertex, parent = id of the label holding it
+    driveWs.reset(graph.getNumVertex());
+    // smallest walk among the walking labels settled at each vertex
+    unordered_map<int, double> settledWalk;
+    auto minSettledWalk = [&](int v) {
+        auto it = settledWalk.find(v);
+        return it == settledWalk.end() ? INF : it->second;
+    };
+
+    vector<ParetoLabel> labels;
+    vector<int> settledAtDestination;
+    priority_queue<tuple<double, double, int>, vector<tuple<double, double, int>>, greater<>> pq;
+
+    auto push = [&](double total, double walk, int vertex, int parent, bool walking) {
+        labels.push_back({total, walk, vertex, parent, walking});
+        pq.emplace(total, walk, labels.size() - 1);
+        return (int) labels.size() - 1;
+    };
+    // A walking label is useless if a label settled at its vertex walks no more, or if even the
+    // shortest rest of the walk leaves it over budget or no better than a trade-off already found
+    auto dominated = [&](int vertex, double walk) {
+        double rest = walkWs.getDist(vertex);
+        return rest == INF || walk + rest > maxWalk || walk >= minSettledWalk(vertex)
+               || walk + rest >= minSettledWalk(t);
+    };
+
+    driveWs.setDist(s, 0);
+    driveWs.setParent(s, push(0, 0, s, -1, false));
+
+    while (!pq.empty()) {
+        auto [total, walk, id] = pq.top(); pq.pop();
+        int v = labels[id].vertex;
+
+        if (!labels[id].walking) {
+            if (driveWs.getParent(v) != id) continue; // a faster drive to v was found later
+            if (unsettledCandidates.empty()) continue; // every usable parking node is settled
+
+            // Leave the car here
+            if (unsettledCandidates.erase(v) && !dominated(v, 0)) {
+                push(total, 0, v, id, true);
+            }
+
+            for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+                int w = graph.getTarget(e);
+                if (blockedNodes[w] || blockedEdges[e]) continue;
+                double weight = graph.getDrivingWeight(e);
+                if (weight == INF) continue;
+
+                if (total + weight < driveWs.getDist(w)) {
+                    driveWs.setDist(w, total + weight);
+                    driveWs.setParent(w, push(total + weight, 0, w, id, false));
+                }
+            }
+            continue;
+        }
+
+        if (dominated(v, walk)) continue;
+        settledWalk[v] = walk;
+        if (v == t) {
+            settledAtDestination.push_back(id);
+            continue;
+        }
+
+        // Walking legs run towards the destination over incoming edges, so they follow the
+        // destination-rooted walking trees of findEnvFriendlyRoute
+        for (int k = graph.inEdgeBegin(v); k < graph.inEdgeEnd(v); k++) {
+            int u = graph.getInSource(k);
+            int e = graph.getInEdge(k);
+            if (blockedNodes[u] || blockedEdges[e]) continue;
+            double nextWalk = walk + graph.getWalkingWeight(e);
+            if (dominated(u, nextWalk)) continue;
+            push(total + graph.getWalkingWeight(e), nextWalk, u, id, true);
+        }
+    }
+
+    for (int id : settledAtDestination) {
+        const ParetoLabel& label = labels[id];
+        vector<int> walkingPath, drivingPath;
+        int carLabel = collectParetoLeg(graph, labels, id, walkingPath);     // destination ... parking
+        collectParetoLeg(graph, labels, carLabel, drivingPath);               // parking ... source
+        reverse(drivingPath.begin(), drivingPath.end());
+        reverse(walkingPath.begin(), walkingPath.end());
+
+        front.push_back({walkingPath.front(), label.total - label.walk, label.walk, label.total,
+                         drivingPath, walkingPath});
+    }
+    return front;
+}
@@ -0,0 +1,40 @@
+#ifndef PARETO_ROUTE_H
+#define PARETO_ROUTE_H
+
+#include <vector>
+#include <utility>
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
+#include "EnvFriendlyRoute.h"
+
+/**
+ * Every trade-off between total time and walking time for a driving + walking trip, in one
+ * multi-criteria label-setting search.
+ *
+ * A label is a partial trip (total, walk) at a vertex, either still driving or already walking
+ * (after leaving the car at a parking node other than source and destination). Labels are
+ * settled in lexicographic (total, walk) order, so a walking label is kept only if its walk is
+ * below that of every label already settled at its vertex; driving labels carry walk = 0 and
+ * reduce to plain Dijkstra. A walking search from the destination bounded by maxWalkTime
+ * (findWalkableParking) first gives the parking nodes worth stopping at and, for every vertex,
+ * the shortest rest of the walk; walking labels that would exceed maxWalkTime or cannot beat a
+ * trade-off already found at the destination are pruned with it, and the driving labels stop
+ * once every such parking node has been settled.
+ *
+ * Returns the Pareto front as EnvFriendlyRoute entries (without alternatives), by increasing
+ * total time and therefore decreasing walking time. The same (total, walk) point reached
+ * through two parking nodes is reported once. An empty vector means no trip exists.
+ * Avoided nodes and segments apply to both legs, as in findEnvFriendlyRoute.
+ */
+std::vector<EnvFriendlyRoute> findParetoEnvRoutes(
+        const CsrGraph& graph,
+        int source,
+        int destination,
+        double maxWalkTime,
+        const std::vector<int>& avoidNodes,
+        const std::vector<std::pair<int, int>>& avoidSegments,
+        SearchWorkspace& driveWs = SearchWorkspace::forThread(0),
+        SearchWorkspace& walkWs = SearchWorkspace::forThread(1)
+);
+
+#endif // PARETO_ROUTE_H
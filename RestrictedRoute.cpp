@@ -1,5 +1,6 @@
 #include "RestrictedRoute.h"
-#include "data_structures/MutablePriorityQueue.h"
+#include "BidirectionalSearch.h"
+#include "data_structures/IndexedPriorityQueue.h"
 #include <unordered_set>
 #include <algorithm>
 #include <limits>
@@ -16,72 +17,64 @@ struct pair_hash {
 };
 
 template <class T>
-bool relaxDrivingOnly(Edge<T> *edge) {
-    auto u = edge->getOrig();
-    auto v = edge->getDest();
+bool relaxDrivingOnly(Edge<T> *edge, SearchWorkspace &ws) {
+    int u = edge->getOrig()->getIndex();
+    int v = edge->getDest()->getIndex();
     double weight = edge->getDrivingWeight();
-    if (u->getDist() + weight < v->getDist()) {
-        v->setDist(u->getDist() + weight);
-        v->setPath(edge);
+    if (ws.getDist(u) + weight < ws.getDist(v)) {
+        ws.setDist(v, ws.getDist(u) + weight);
+        ws.setParent(v, u);
         return true;
     }
     return false;
 }
 
 template <class T>
-void dijkstraDriving(Graph<T> *g, int origin, const unordered_set<int> &avoidNodes, const unordered_set<pair<int, int>, pair_hash> &avoidSegments) {
-    for (auto v : g->getVertexSet()) {
-        v->setDist(INF);
-        v->setPath(nullptr);
-    }
-
-    auto s = g->findVertex(origin);
-    if (!s) return;
+void dijkstraDriving(const Graph<T> *g, int origin, const vector<char> &avoidNodes, const unordered_set<pair<int, int>, pair_hash> &avoidSegments, SearchWorkspace &ws) {
+    ws.reset(g->getNumVertex());
+    int s = g->findVertexIdx(origin);
+    if (s == -1) return;
 
-    s->setDist(0);
-    MutablePriorityQueue<Vertex<T>> q;
+    ws.setDist(s, 0);
+    IndexedPriorityQueue q(ws);
     q.insert(s);
 
     while (!q.empty()) {
-        auto v = q.extractMin();
+        auto v = g->getVertex(q.extractMin());
         for (auto e : v->getAdj()) {
             auto u = e->getOrig()->getInfo();
             auto v_ = e->getDest()->getInfo();
+            int w = e->getDest()->getIndex();
 
-            if (avoidNodes.count(v_)) continue;
+            if (avoidNodes[w]) continue;
             if (avoidSegments.count({u, v_}) || avoidSegments.count({v_, u})) continue;
 
-            auto oldDist = e->getDest()->getDist();
-            if (relaxDrivingOnly(e)) {
-                if (oldDist == INF) q.insert(e->getDest());
-                else q.decreaseKey(e->getDest());
+            auto oldDist = ws.getDist(w);
+            if (relaxDrivingOnly(e, ws)) {
+                if (oldDist == INF) q.insert(w);
+                else q.decreaseKey(w);
             }
         }
     }
 }
 
 template <class T>
-vector<T> getDrivingPath(Graph<T> *g, int origin, int dest) {
+vector<T> getDrivingPath(const Graph<T> *g, int dest, const SearchWorkspace &ws) {
     vector<T> path;
-    auto v = g->findVertex(dest);
-    if (!v || v->getDist() == INF) return {};
-    while (v) {
-        path.push_back(v->getInfo());
-        if (!v->getPath()) break;
-        v = v->getPath()->getOrig();
+    int t = g->findVertexIdx(dest);
+    if (t == -1 || ws.getDist(t) == INF) return {};
+    for (int v = t; v != -1; v = ws.getParent(v)) {
+        path.push_back(g->getVertex(v)->getInfo());
     }
     reverse(path.begin(), path.end());
     return path;
 }
 
-vector<int> restrictedDrivingRoute(Graph<int> &graph, int source, int destination, const vector<int> &avoidNodes, const vector<pair<int, int>> &avoidSegments, int includeNode) {
-    unordered_set<int> avoidNodeSet(avoidNodes.begin(), avoidNodes.end());
-    unordered_set<pair<int, int>, pair_hash> avoidSegmentSet(avoidSegments.begin(), avoidSegments.end());
-
+vector<int> restrictedDrivingRoute(const Graph<int> &graph, int source, int destination, const vector<int> &avoidNodes, const vector<pair<int, int>> &avoidSegments, int includeNode, SearchWorkspace &ws) {
     // If there's a node that MUST be visited, split into two Dijkstra runs
     if (includeNode != -1 && includeNode != source && includeNode != destination) {
-        auto toIncludePath = restrictedDrivingRoute(graph, source, includeNode, avoidNodes, avoidSegments, -1);
-        auto fromIncludePath = restrictedDrivingRoute(graph, includeNode, destination, avoidNodes, avoidSegments, -1);
+        auto toIncludePath = restrictedDrivingRoute(graph, source, includeNode, avoidNodes, avoidSegments, -1, ws);
+        auto fromIncludePath = restrictedDrivingRoute(graph, includeNode, destination, avoidNodes, avoidSegments, -1, ws);
 
         if (toIncludePath.empty() || fromIncludePath.empty()) return {};
 
@@ -90,6 +83,75 @@ vector<int> restrictedDrivingRoute(Graph<int> &graph, int source, int destinatio
         return toIncludePath;
     }
 
-    dijkstraDriving(&graph, source, avoidNodeSet, avoidSegmentSet);
-    return getDrivingPath(&graph, source, destination);
+    vector<char> avoidNodeMask(graph.getNumVertex(), 0); // indexed by dense vertex index
+    for (int node : avoidNodes) {
+        int idx = graph.findVertexIdx(node);
+        if (idx != -1) avoidNodeMask[idx] = 1;
+    }
+    unordered_set<pair<int, int>, pair_hash> avoidSegmentSet(avoidSegments.begin(), avoidSegments.end());
+
+    dijkstraDriving(&graph, source, avoidNodeMask, avoidSegmentSet, ws);
+    return getDrivingPath(&graph, destination, ws);
+}
+
+vector<int> restrictedDrivingRoute(const CsrGraph &graph, int source, int destination, const vector<int> &avoidNodes, const vector<pair<int, int>> &avoidSegments, int includeNode,
+                                   SearchWorkspace &ws, SearchWorkspace &backwardWs) {
+    vector<int> includeNodes;
+    if (includeNode != -1) includeNodes.push_back(includeNode);
+    return waypointDrivingRoute(graph, source, destination, includeNodes, avoidNodes, avoidSegments, ws, backwardWs);
+}
+
+vector<int> waypointStops(const CsrGraph &graph, int source, int destination, const vector<int> &includeNodes) {
+    vector<int> stops;
+    auto addStop = [&](int id) {
+        int v = graph.getIndex(id);
+        if (v == -1) return false;
+        if (stops.empty() || stops.back() != v) stops.push_back(v);
+        return true;
+    };
+    if (!addStop(source)) return {};
+    for (int id : includeNodes) {
+        if (!addStop(id)) return {};
+    }
+    if (!addStop(destination)) return {};
+    return stops;
+}
+
+vector<int> waypointDrivingRoute(const CsrGraph &graph, int source, int destination, const vector<int> &includeNodes,
+                                 const vector<int> &avoidNodes, const vector<pair<int, int>> &avoidSegments,
+                                 SearchWorkspace &ws, SearchWorkspace &backwardWs) {
+    auto stops = waypointStops(graph, source, destination, includeNodes);
+    if (stops.empty()) return {};
+    if (stops.size() == 1) return {graph.getId(stops[0])};
+
+    vector<char> blockedNodes, blockedEdges;
+    buildAvoidMasks(graph, avoidNodes, avoidSegments, blockedNodes, blockedEdges);
+
+    vector<int> path;
+    for (size_t i = 0; i + 1 < stops.size(); i++) {
+        if (!path.empty()) path.pop_back(); // the leg starts with the stop the last one ended at
+        if (bidirectionalDijkstra(graph, stops[i], stops[i + 1], blockedNodes, blockedEdges, ws, backwardWs, path) == INF) return {};
+    }
+    return path;
+}
+
+void buildAvoidMasks(const CsrGraph &graph, const vector<int> &avoidNodes, const vector<pair<int, int>> &avoidSegments,
+                     vector<char> &blockedNodes, vector<char> &blockedEdges) {
+    blockedNodes.assign(graph.getNumVertex(), 0);
+    for (int node : avoidNodes) {
+        int v = graph.getIndex(node);
+        if (v != -1) blockedNodes[v] = 1;
+    }
+
+    // A segment is avoided in both directions, so flag every CSR edge joining its endpoints
+    blockedEdges.assign(graph.getNumEdges(), 0);
+    for (auto [a, b] : avoidSegments) {
+        int u = graph.getIndex(a);
+        int v = graph.getIndex(b);
+        if (u == -1 || v == -1) continue;
+        for (int e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++)
+            if (graph.getTarget(e) == v) blockedEdges[e] = 1;
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++)
+            if (graph.getTarget(e) == u) blockedEdges[e] = 1;
+    }
 }
@@ -2,18 +2,69 @@
 #define RESTRICTED_ROUTE_H
 
 #include "data_structures/Graph.h"
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
 
 /**
  * Computes the fastest driving route from source to destination,
  * avoiding specified nodes and segments and optionally passing through a given includeNode.
  * Returns the sequence of node IDs that represent the path.
+ * Search state lives in ws, the graph is only read.
  */
 std::vector<int> restrictedDrivingRoute(
-        Graph<int> &graph,
+        const Graph<int> &graph,
         int source,
         int destination,
         const std::vector<int> &avoidNodes,
         const std::vector<std::pair<int, int>> &avoidSegments,
-        int includeNode);
+        int includeNode,
+        SearchWorkspace &ws = SearchWorkspace::forThread());
+
+/**
+ * Same query answered on an immutable CSR snapshot, with a bidirectional point-to-point
+ * search per leg; the avoid lists become node and edge masks shared by both directions.
+ */
+std::vector<int> restrictedDrivingRoute(
+        const CsrGraph &graph,
+        int source,
+        int destination,
+        const std::vector<int> &avoidNodes,
+        const std::vector<std::pair<int, int>> &avoidSegments,
+        int includeNode,
+        SearchWorkspace &ws = SearchWorkspace::forThread(0),
+        SearchWorkspace &backwardWs = SearchWorkspace::forThread(1));
+
+/**
+ * Restricted route that visits includeNodes (CSV Ids) in the given order. The avoid masks are
+ * built once and shared by one bidirectional search per leg; every leg is appended in place
+ * to the returned path. A stop equal to the one before it adds no leg. Returns an empty
+ * vector if an id is unknown or any leg is unreachable.
+ */
+std::vector<int> waypointDrivingRoute(
+        const CsrGraph &graph,
+        int source,
+        int destination,
+        const std::vector<int> &includeNodes,
+        const std::vector<int> &avoidNodes,
+        const std::vector<std::pair<int, int>> &avoidSegments,
+        SearchWorkspace &ws = SearchWorkspace::forThread(0),
+        SearchWorkspace &backwardWs = SearchWorkspace::forThread(1));
+
+/**
+ * Dense indices of source, the waypoints and destination, without stops equal to the one
+ * before them; empty if any id is unknown.
+ */
+std::vector<int> waypointStops(const CsrGraph &graph, int source, int destination, const std::vector<int> &includeNodes);
+
+/**
+ * Turns avoid lists (CSV Ids) into masks over the CSR snapshot: blockedNodes is indexed by
+ * dense vertex index, blockedEdges by edge id. A segment is avoided in both directions, so
+ * every edge joining its endpoints is flagged. Unknown ids are ignored.
+ */
+void buildAvoidMasks(const CsrGraph &graph,
+                     const std::vector<int> &avoidNodes,
+                     const std::vector<std::pair<int, int>> &avoidSegments,
+                     std::vector<char> &blockedNodes,
+                     std::vector<char> &blockedEdges);
 
 #endif // RESTRICTED_ROUTE_H
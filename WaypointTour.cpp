@@ -0,0 +1,222 @@
+#include "WaypointTour.h"
+#include "RestrictedRoute.h"
+#include "data_structures/SearchQueue.h"
+#include <algorithm>
+
+using namespace std;
+
+// Stand-in for a leg that cannot be driven: loses to any real route, and sums of a few of them stay finite
+const double unreachableLeg = 1e15;
+
+/*
+ * Driving Dijkstra from dense index from on the avoid masks, stopped once every stop is
+ * settled. row[j] becomes the time to stops[j] (unreachableLeg if there is no route).
+ */
+void fillStopTimes(const CsrGraph &graph, int from, const vector<int> &stops, const vector<char> &blockedNodes,
+                   const vector<char> &blockedEdges, SearchWorkspace &ws, vector<double> &row) {
+    vector<int> pending = stops;
+    sort(pending.begin(), pending.end());
+    pending.erase(unique(pending.begin(), pending.end()), pending.end());
+    size_t unsettled = pending.size();
+
+    ws.reset(graph.getNumVertex());
+    ws.setDist(from, 0);
+    withSearchQueue(graph, [&](auto makeQueue) {
+        auto q = makeQueue(ws);
+        q.insert(from);
+
+        while (!q.empty()) {
+            int v = q.extractMin();
+            double d = ws.getDist(v);
+            if (binary_search(pending.begin(), pending.end(), v) && --unsettled == 0) break;
+
+            for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++) {
+                int w = graph.getTarget(e);
+                if (blockedNodes[w] || blockedEdges[e]) continue;
+                double weight = graph.getDrivingWeight(e);
+                if (weight == INF) continue;
+
+                auto oldDist = ws.getDist(w);
+                if (d + weight < oldDist) {
+                    ws.setDist(w, d + weight);
+                    ws.setParent(w, v);
+                    if (oldDist == INF) q.insert(w);
+                    else q.decreaseKey(w);
+                }
+            }
+        }
+    });
+
+    row.resize(stops.size());
+    for (size_t j = 0; j < stops.size(); j++) {
+        double d = ws.getDist(stops[j]);
+        row[j] = d == INF ? unreachableLeg : d;
+    }
+}
+
+/*
+ * Driving time of a stop sequence; time[i][j] is the time from stop i to stop j.
+ */
+double tourTime(const vector<vector<double>> &time, const vector<int> &seq) {
+    double total = 0;
+    for (size_t i = 0; i + 1 < seq.size(); i++) total += time[seq[i]][seq[i + 1]];
+    return total;
+}
+
+/*
+ * Held-Karp over waypoints 1..m, from stop 0 to stop m + 1. Returns the whole stop sequence.
+ */
+vector<int> heldKarpOrder(const vector<vector<double>> &time, int m) {
+    if (m == 0) return {0, 1};
+
+    // best[mask * m + j]: fastest way from stop 0 through the waypoints in mask, ending at waypoint j + 1
+    size_t numMasks = (size_t) 1 << m;
+    vector<double> best(numMasks * m, INF);
+    vector<signed char> previous(numMasks * m, -1);
+    for (int j = 0; j < m; j++) best[((size_t) 1 << j) * m + j] = time[0][j + 1];
+
+    for (size_t mask = 1; mask < numMasks; mask++) {
+        for (int j = 0; j < m; j++) {
+            double cur = best[mask * m + j];
+            if (!(mask >> j & 1) || cur == INF) continue;
+            for (int k = 0; k < m; k++) {
+                if (mask >> k & 1) continue;
+                size_t next = (mask | (size_t) 1 << k) * m + k;
+                double candidate = cur + time[j + 1][k + 1];
+                if (candidate < best[next]) {
+                    best[next] = candidate;
+                    previous[next] = j;
+                }
+            }
+        }
+    }
+
+    size_t mask = numMasks - 1;
+    int last = 0;
+    for (int j = 1; j < m; j++) {
+        if (best[mask * m + j] + time[j + 1][m + 1] < best[mask * m + last] + time[last + 1][m + 1]) last = j;
+    }
+    vector<int> seq = {m + 1};
+    for (int j = last; j != -1; ) {
+        seq.push_back(j + 1);
+        int prev = previous[mask * m + j];
+        mask &= ~((size_t) 1 << j);
+        j = prev;
+    }
+    seq.push_back(0);
+    reverse(seq.begin(), seq.end());
+    return seq;
+}
+
+/*
+ * Nearest-neighbour order of waypoints 1..m, improved with 2-opt (reverse a run of waypoints)
+ * and Or-opt (move a run of up to three waypoints elsewhere) until no move shortens the route
+ * or the deadline passes. The table may be asymmetric, so reversals are priced in full.
+ */
+vector<int> localSearchOrder(const vector<vector<double>> &time, int m, chrono::steady_clock::time_point deadline) {
+    const double eps = 1e-9;
+    vector<int> seq = {0};
+    vector<char> used(m + 2, 0);
+    for (int step = 0; step < m; step++) {
+        int from = seq.back(), next = -1;
+        for (int j = 1; j <= m; j++) {
+            if (!used[j] && (next == -1 || time[from][j] < time[from][next])) next = j;
+        }
+        used[next] = 1;
+        seq.push_back(next);
+    }
+    seq.push_back(m + 1);
+
+    // forward[k] / backward[k]: time of seq[0..k] driven as listed / against the listed order
+    vector<double> forward(m + 2), backward(m + 2);
+    auto updatePrefixes = [&]() {
+        for (int k = 1; k <= m + 1; k++) {
+            forward[k] = forward[k - 1] + time[seq[k - 1]][seq[k]];
+            backward[k] = backward[k - 1] + time[seq[k]][seq[k - 1]];
+        }
+    };
+
+    auto twoOpt = [&]() {
+        updatePrefixes();
+        bool improved = false;
+        for (int i = 1; i < m && chrono::steady_clock::now() < deadline; i++) {
+            for (int j = i + 1; j <= m; j++) {
+                int a = seq[i - 1], b = seq[j + 1];
+                double before = time[a][seq[i]] + (forward[j] - forward[i]) + time[seq[j]][b];
+                double after = time[a][seq[j]] + (backward[j] - backward[i]) + time[seq[i]][b];
+                if (after < before - eps) {
+                    reverse(seq.begin() + i, seq.begin() + j + 1);
+                    updatePrefixes();
+                    improved = true;
+                }
+            }
+        }
+        return improved;
+    };
+
+    auto orOpt = [&]() {
+        for (int len = 1; len <= 3 && len < m; len++) {
+            for (int i = 1; i + len <= m && chrono::steady_clock::now() < deadline; i++) {
+                int first = seq[i], last = seq[i + len - 1];
+                int p = seq[i - 1], q = seq[i + len];
+                double removed = time[p][first] + time[last][q] - time[p][q];
+                for (int k = 0; k <= m; k++) {
+                    if (k >= i - 1 && k < i + len) continue; // inside the run or next to it
+                    int a = seq[k], b = seq[k + 1];
+                    double added = time[a][first] + time[last][b] - time[a][b];
+                    if (added < removed - eps) {
+                        vector<int> run(seq.begin() + i, seq.begin() + i + len);
+                        seq.erase(seq.begin() + i, seq.begin() + i + len);
+                        int at = k < i ? k + 1 : k + 1 - len;
+                        seq.insert(seq.begin() + at, run.begin(), run.end());
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    };
+
+    while (chrono::steady_clock::now() < deadline) {
+        bool improved = twoOpt();
+        improved = orOpt() || improved;
+        if (!improved) break;
+    }
+    return seq;
+}
+
+vector<int> optimizedWaypointRoute(const CsrGraph &graph, int source, int destination, const vector<int> &includeNodes,
+                                   const vector<int> &avoidNodes, const vector<pair<int, int>> &avoidSegments,
+                                   chrono::milliseconds timeLimit, SearchWorkspace &ws, SearchWorkspace &backwardWs) {
+    auto deadline = chrono::steady_clock::now() + timeLimit;
+    int s = graph.getIndex(source);
+    int t = graph.getIndex(destination);
+    if (s == -1 || t == -1) return {};
+
+    // Stop 0 is the source, then the distinct waypoints, then the destination
+    vector<int> stops = {s};
+    for (int id : includeNodes) {
+        int v = graph.getIndex(id);
+        if (v == -1) return {};
+        if (v != t && find(stops.begin(), stops.end(), v) == stops.end()) stops.push_back(v);
+    }
+    int m = stops.size() - 1;
+    stops.push_back(t);
+
+    vector<char> blockedNodes, blockedEdges;
+    buildAvoidMasks(graph, avoidNodes, avoidSegments, blockedNodes, blockedEdges);
+
+    // The destination is never left, so it needs no row
+    vector<vector<double>> time(m + 1);
+    for (int i = 0; i <= m; i++) {
+        fillStopTimes(graph, stops[i], stops, blockedNodes, blockedEdges, ws, time[i]);
+    }
+    time.emplace_back(m + 2, unreachableLeg);
+
+    auto seq = m <= exactWaypointLimit ? heldKarpOrder(time, m) : localSearchOrder(time, m, deadline);
+    if (tourTime(time, seq) >= unreachableLeg) return {};
+
+    vector<int> ordered;
+    for (size_t i = 1; i + 1 < seq.size(); i++) ordered.push_back(graph.getId(stops[seq[i]]));
+    return waypointDrivingRoute(graph, source, destination, ordered, avoidNodes, avoidSegments, ws, backwardWs);
+}
@@ -0,0 +1,39 @@
+#ifndef WAYPOINT_TOUR_H
+#define WAYPOINT_TOUR_H
+
+#include <vector>
+#include <utility>
+#include <chrono>
+#include "data_structures/CsrGraph.h"
+#include "data_structures/SearchWorkspace.h"
+
+/**
+ * Restricted driving route from source to destination that visits every node of includeNodes
+ * (CSV Ids) in the order that makes it fastest.
+ *
+ * The stop-to-stop driving times come from one Dijkstra per stop on the restricted-route
+ * avoid masks. Up to exactWaypointLimit waypoints the order is solved exactly (Held-Karp);
+ * beyond that a nearest-neighbour order is improved with 2-opt and Or-opt moves until none
+ * helps or timeLimit runs out. The legs are then stitched by waypointDrivingRoute, so the
+ * result has the same format as restrictedDrivingRoute. Waypoints equal to source,
+ * destination or an earlier waypoint are visited once. Returns an empty vector if an id is
+ * unknown or some waypoint cannot be fitted into any route.
+ */
+std::vector<int> optimizedWaypointRoute(
+        const CsrGraph &graph,
+        int source,
+        int destination,
+        const std::vector<int> &includeNodes,
+        const std::vector<int> &avoidNodes,
+        const std::vector<std::pair<int, int>> &avoidSegments,
+        std::chrono::milliseconds timeLimit = std::chrono::milliseconds(1000),
+        SearchWorkspace &ws = SearchWorkspace::forThread(0),
+        SearchWorkspace &backwardWs = SearchWorkspace::forThread(1)
+);
+
+/**
+ * Largest number of waypoints optimizedWaypointRoute orders exactly.
+ */
+constexpr int exactWaypointLimit = 13;
+
+#endif // WAYPOINT_TOUR_H
@@ -0,0 +1,327 @@
+#ifndef DA_PROJECT1_CSRGRAPH_H
+#define DA_PROJECT1_CSRGRAPH_H
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include "Graph.h"
+
+/**
+ * Immutable compressed-sparse-row snapshot of a loaded Graph<int>.
+ * Vertices are renumbered to dense indices 0..n-1 (in vertexSet order) and the
+ * outgoing edges of vertex v live contiguously in [edgeBegin(v), edgeEnd(v)).
+ * Targets and the two weight kinds are kept in separate arrays so a driving
+ * search never touches walking weights and vice versa. Weights are stored as floats (exact for
+ * whole numbers up to 2^24) and read back as doubles, with INF for a non-drivable segment.
+ * The incoming edges of v are mirrored in [inEdgeBegin(v), inEdgeEnd(v)) for backward searches;
+ * each entry names the source vertex and the forward edge id, so weights and per-edge masks
+ * are shared by both directions.
+ * The snapshot also records whether every finite weight is a non-negative integer, which lets
+ * searches use the monotone integer queues (see SearchQueue.h).
+ * Every array is read through a span, so the same queries run on arrays built here or on a
+ * memory-mapped snapshot file used in place (see GraphSnapshot.h).
+ */
+class CsrGraph {
+public:
+    explicit CsrGraph(const Graph<int> &graph);
+
+    // The spans point into this object (or its mapping), so it is neither copied nor moved
+    CsrGraph(const CsrGraph &) = delete;
+    CsrGraph &operator=(const CsrGraph &) = delete;
+
+    int getNumVertex() const;
+    int getNumEdges() const;
+
+    /*
+     * Dense index of the vertex with the given CSV Id, or -1 if it does not exist.
+     */
+    int getIndex(int id) const;
+    int getId(int v) const;
+    int getParking(int v) const;
+    /*
+     * Dense indices of every vertex with parking, ascending.
+     */
+    std::span<const int> getParkingVertices() const;
+    /*
+     * Location name and code of a vertex, views into the interned string table.
+     */
+    std::string_view getLocation(int v) const;
+    std::string_view getCode(int v) const;
+
+    int edgeBegin(int v) const;
+    int edgeEnd(int v) const;
+    int getTarget(int e) const;
+    double getDrivingWeight(int e) const;
+    double getWalkingWeight(int e) const;
+
+    int inEdgeBegin(int v) const;
+    int inEdgeEnd(int v) const;
+    int getInSource(int k) const;
+    int getInEdge(int k) const;
+
+    /*
+     * True if every finite driving and walking weight is a non-negative integer;
+     * getMaxWeight() is then the largest of them.
+     */
+    bool hasIntegralWeights() const;
+    double getMaxWeight() const;
+
+    /*
+     * Bytes of the arrays searches read (topology in both directions and weights) and of the
+     * per-vertex metadata (Ids, parking, names), whether built here or mapped.
+     */
+    size_t getSearchBytes() const;
+    size_t getMetadataBytes() const;
+
+protected:
+    std::span<const int> offsets;          // size n+1, edges of v are [offsets[v], offsets[v+1])
+    std::span<const int> targets;          // dense index of each edge's destination
+    std::span<const float> drivingWeights; // infinity marks a non-drivable segment
+    std::span<const float> walkingWeights;
+
+    std::span<const int> inOffsets;        // size n+1, incoming edges of v are [inOffsets[v], inOffsets[v+1])
+    std::span<const int> inSources;        // dense index of the incoming edge's origin
+    std::span<const int> inEdges;          // forward edge id of the incoming edge
+
+    std::span<const int> ids;              // dense index -> CSV Id
+    std::span<const int> idOrder;          // dense indices sorted by CSV Id, searched by getIndex
+    std::span<const char> parking;         // dense index -> 1 if parking exists
+    std::span<const int> parkingVertices;  // dense indices with parking
+
+    std::span<const int> locationNames;    // dense index -> string number of its location name
+    std::span<const int> codeNames;        // dense index -> string number of its code
+    std::span<const int> stringOffsets;    // size numStrings+1, string i is [stringOffsets[i], stringOffsets[i+1])
+    std::span<const char> stringData;      // every distinct name and code, stored once
+
+    bool integralWeights = true;
+    double maxWeight = 0;
+
+    // Arrays built by the Graph<int> constructor; all empty for a mapped snapshot
+    struct Arrays {
+        std::vector<int> offsets, targets, inOffsets, inSources, inEdges;
+        std::vector<float> drivingWeights, walkingWeights;
+        std::vector<int> ids, idOrder, parkingVertices, locationNames, codeNames, stringOffsets;
+        std::vector<char> parking, stringData;
+    } owned;
+    std::shared_ptr<const void> mapping;   // keeps a mapped snapshot alive, unmapped on release
+
+    CsrGraph() = default;
+
+    /*
+     * Stored form of a weight: INF becomes float infinity, anything else is rounded to float.
+     */
+    static float packWeight(double weight);
+
+    /*
+     * Completes owned once its vertex arrays, strings and forward adjacency are filled: sorts
+     * the Id order, checks the weights, builds the reverse adjacency and points the spans at owned.
+     */
+    void finishOwnedArrays();
+
+    friend bool writeGraphSnapshot(const CsrGraph &graph, const std::string &path);
+    friend std::unique_ptr<CsrGraph> loadGraphSnapshot(const std::string &path);
+    friend std::unique_ptr<CsrGraph> loadCsvGraph(const std::string &locationsPath,
+                                                  const std::string &distancesPath, unsigned numThreads);
+};
+
+inline CsrGraph::CsrGraph(const Graph<int> &graph) {
+    auto vertices = graph.getVertexSet();
+    int n = vertices.size();
+
+    owned.ids.resize(n);
+    owned.parking.resize(n);
+    owned.locationNames.resize(n);
+    owned.codeNames.resize(n);
+    owned.stringOffsets.push_back(0);
+    std::unordered_map<std::string, int> interned;
+    auto intern = [&](const std::string &text) {
+        auto [it, inserted] = interned.emplace(text, (int) interned.size());
+        if (inserted) {
+            owned.stringData.insert(owned.stringData.end(), text.begin(), text.end());
+            owned.stringOffsets.push_back(owned.stringData.size());
+        }
+        return it->second;
+    };
+    for (int i = 0; i < n; i++) {
+        owned.ids[i] = vertices[i]->getInfo();
+        owned.parking[i] = vertices[i]->getParking() == 1;
+        if (owned.parking[i]) owned.parkingVertices.push_back(i);
+        owned.locationNames[i] = intern(vertices[i]->getLocation());
+        owned.codeNames[i] = intern(vertices[i]->getCode());
+    }
+
+    owned.offsets.assign(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        owned.offsets[i + 1] = owned.offsets[i] + vertices[i]->getAdj().size();
+    }
+
+    int m = owned.offsets[n];
+    owned.targets.resize(m);
+    owned.drivingWeights.resize(m);
+    owned.walkingWeights.resize(m);
+    for (int i = 0; i < n; i++) {
+        int e = owned.offsets[i];
+        for (auto edge : vertices[i]->getAdj()) {
+            owned.targets[e] = edge->getDest()->getIndex();
+            owned.drivingWeights[e] = packWeight(edge->getDrivingWeight());
+            owned.walkingWeights[e] = packWeight(edge->getWalkingWeight());
+            e++;
+        }
+    }
+    finishOwnedArrays();
+}
+
+inline void CsrGraph::finishOwnedArrays() {
+    int n = owned.ids.size();
+    int m = owned.targets.size();
+    owned.idOrder.resize(n);
+    for (int i = 0; i < n; i++) owned.idOrder[i] = i;
+    std::sort(owned.idOrder.begin(), owned.idOrder.end(),
+              [&](int a, int b) { return owned.ids[a] < owned.ids[b]; });
+
+    for (int e = 0; e < m; e++) {
+        for (double w : {owned.drivingWeights[e], owned.walkingWeights[e]}) {
+            if (std::isinf(w)) continue;
+            if (w < 0 || w > 1e15 || w != (double) (long long) w) integralWeights = false;
+            else maxWeight = std::max(maxWeight, w);
+        }
+    }
+
+    // Reverse adjacency by counting sort on the targets
+    owned.inOffsets.assign(n + 1, 0);
+    for (int e = 0; e < m; e++) owned.inOffsets[owned.targets[e] + 1]++;
+    for (int v = 0; v < n; v++) owned.inOffsets[v + 1] += owned.inOffsets[v];
+    owned.inSources.resize(m);
+    owned.inEdges.resize(m);
+    std::vector<int> fill(owned.inOffsets.begin(), owned.inOffsets.end() - 1);
+    for (int v = 0; v < n; v++) {
+        for (int e = owned.offsets[v]; e < owned.offsets[v + 1]; e++) {
+            int k = fill[owned.targets[e]]++;
+            owned.inSources[k] = v;
+            owned.inEdges[k] = e;
+        }
+    }
+
+    offsets = owned.offsets;
+    targets = owned.targets;
+    drivingWeights = owned.drivingWeights;
+    walkingWeights = owned.walkingWeights;
+    inOffsets = owned.inOffsets;
+    inSources = owned.inSources;
+    inEdges = owned.inEdges;
+    ids = owned.ids;
+    idOrder = owned.idOrder;
+    parking = owned.parking;
+    parkingVertices = owned.parkingVertices;
+    locationNames = owned.locationNames;
+    codeNames = owned.codeNames;
+    stringOffsets = owned.stringOffsets;
+    stringData = owned.stringData;
+}
+
+inline float CsrGraph::packWeight(double weight) {
+    return weight == INF ? std::numeric_limits<float>::infinity() : (float) weight;
+}
+
+inline int CsrGraph::getNumVertex() const {
+    return ids.size();
+}
+
+inline int CsrGraph::getNumEdges() const {
+    return targets.size();
+}
+
+inline int CsrGraph::getIndex(int id) const {
+    auto it = std::lower_bound(idOrder.begin(), idOrder.end(), id,
+                               [this](int v, int key) { return ids[v] < key; });
+    if (it != idOrder.end() && ids[*it] == id) {
+        return *it;
+    }
+    return -1;
+}
+
+inline int CsrGraph::getId(int v) const {
+    return ids[v];
+}
+
+inline int CsrGraph::getParking(int v) const {
+    return parking[v];
+}
+
+inline std::span<const int> CsrGraph::getParkingVertices() const {
+    return parkingVertices;
+}
+
+inline std::string_view CsrGraph::getLocation(int v) const {
+    int i = locationNames[v];
+    return {stringData.data() + stringOffsets[i], (size_t) (stringOffsets[i + 1] - stringOffsets[i])};
+}
+
+inline std::string_view CsrGraph::getCode(int v) const {
+    int i = codeNames[v];
+    return {stringData.data() + stringOffsets[i], (size_t) (stringOffsets[i + 1] - stringOffsets[i])};
+}
+
+inline int CsrGraph::edgeBegin(int v) const {
+    return offsets[v];
+}
+
+inline int CsrGraph::edgeEnd(int v) const {
+    return offsets[v + 1];
+}
+
+inline int CsrGraph::getTarget(int e) const {
+    return targets[e];
+}
+
+inline double CsrGraph::getDrivingWeight(int e) const {
+    float w = drivingWeights[e];
+    return std::isinf(w) ? INF : w;
+}
+
+inline double CsrGraph::getWalkingWeight(int e) const {
+    float w = walkingWeights[e];
+    return std::isinf(w) ? INF : w;
+}
+
+inline int CsrGraph::inEdgeBegin(int v) const {
+    return inOffsets[v];
+}
+
+inline int CsrGraph::inEdgeEnd(int v) const {
+    return inOffsets[v + 1];
+}
+
+inline int CsrGraph::getInSource(int k) const {
+    return inSources[k];
+}
+
+inline int CsrGraph::getInEdge(int k) const {
+    return inEdges[k];
+}
+
+inline bool CsrGraph::hasIntegralWeights() const {
+    return integralWeights;
+}
+
+inline double CsrGraph::getMaxWeight() const {
+    return maxWeight;
+}
+
+inline size_t CsrGraph::getSearchBytes() const {
+    return offsets.size_bytes() + targets.size_bytes() + drivingWeights.size_bytes() + walkingWeights.size_bytes()
+         + inOffsets.size_bytes() + inSources.size_bytes() + inEdges.size_bytes();
+}
+
+inline size_t CsrGraph::getMetadataBytes() const {
+    return ids.size_bytes() + idOrder.size_bytes() + parking.size_bytes() + parkingVertices.size_bytes()
+         + locationNames.size_bytes() + codeNames.size_bytes() + stringOffsets.size_bytes() + stringData.size_bytes();
+}
+
+#endif //DA_PROJECT1_CSRGRAPH_H
@@ -0,0 +1,107 @@
+#ifndef DA_PROJECT1_DARYHEAP_H
+#define DA_PROJECT1_DARYHEAP_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "SearchWorkspace.h"
+
+/**
+ * Indexed d-ary min-heap over dense vertex indices.
+ *
+ * Unlike IndexedPriorityQueue, each slot keeps its (key, vertex) pair inline, so sifting
+ * compares contiguous keys without reading the workspace. Only the position of each vertex
+ * (1-based, 0 = not queued) lives in the workspace's heap-index array. A larger arity gives
+ * a shallower tree and cheaper decreaseKey at the price of more comparisons per sift-down;
+ * all D children of a slot are adjacent in memory.
+ *
+ * Keys are copied from the workspace dist array on insert() and decreaseKey().
+ */
+template <unsigned D>
+class DaryHeap {
+    static_assert(D >= 2, "a heap needs at least two children per node");
+    SearchWorkspace &ws;
+    std::vector<std::pair<double, int>> H;
+    void siftUp(size_t i, std::pair<double, int> x);
+    void siftDown(size_t i, std::pair<double, int> x);
+    inline void place(size_t i, const std::pair<double, int> &x);
+public:
+    explicit DaryHeap(SearchWorkspace &ws);
+    void insert(int v);
+    int extractMin();
+    int peekMin() const;
+    void decreaseKey(int v);
+    bool empty() const;
+};
+
+template <unsigned D>
+DaryHeap<D>::DaryHeap(SearchWorkspace &ws): ws(ws) {
+}
+
+template <unsigned D>
+bool DaryHeap<D>::empty() const {
+    return H.empty();
+}
+
+template <unsigned D>
+int DaryHeap<D>::peekMin() const {
+    return H[0].second;
+}
+
+template <unsigned D>
+void DaryHeap<D>::insert(int v) {
+    H.emplace_back();
+    siftUp(H.size() - 1, {ws.getDist(v), v});
+}
+
+template <unsigned D>
+void DaryHeap<D>::decreaseKey(int v) {
+    siftUp(ws.getHeapIndex(v) - 1, {ws.getDist(v), v});
+}
+
+template <unsigned D>
+int DaryHeap<D>::extractMin() {
+    int x = H[0].second;
+    auto last = H.back();
+    H.pop_back();
+    if (!H.empty()) siftDown(0, last);
+    ws.setHeapIndex(x, 0);
+    return x;
+}
+
+template <unsigned D>
+void DaryHeap<D>::siftUp(size_t i, std::pair<double, int> x) {
+    while (i > 0) {
+        size_t parent = (i - 1) / D;
+        if (!(x.first < H[parent].first)) break;
+        place(i, H[parent]);
+        i = parent;
+    }
+    place(i, x);
+}
+
+template <unsigned D>
+void DaryHeap<D>::siftDown(size_t i, std::pair<double, int> x) {
+    size_t n = H.size();
+    while (true) {
+        size_t first = i * D + 1;
+        if (first >= n) break;
+        size_t last = std::min(first + D, n);
+        size_t best = first;
+        for (size_t c = first + 1; c < last; c++) {
+            if (H[c].first < H[best].first) best = c;
+        }
+        if (!(H[best].first < x.first)) break;
+        place(i, H[best]);
+        i = best;
+    }
+    place(i, x);
+}
+
+template <unsigned D>
+void DaryHeap<D>::place(size_t i, const std::pair<double, int> &x) {
+    H[i] = x;
+    ws.setHeapIndex(x.second, i + 1);
+}
+
+#endif //DA_PROJECT1_DARYHEAP_H
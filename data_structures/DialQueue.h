@@ -0,0 +1,85 @@
+#ifndef DA_PROJECT1_DIALQUEUE_H
+#define DA_PROJECT1_DIALQUEUE_H
+
+#include <vector>
+#include "SearchWorkspace.h"
+
+/**
+ * Dial's bucket queue for Dijkstra over small non-negative integer weights.
+ *
+ * Every queued key lies in [cursor, cursor + maxWeight], so a ring of maxWeight + 1 buckets
+ * holds them all: bucket k % size holds key k. decreaseKey() just files the vertex again under
+ * its new key; the old entry is recognised as stale (its key no longer matches the workspace
+ * dist) when the cursor reaches it. All operations are O(1) amortized, plus one step of the
+ * cursor per distinct key value.
+ *
+ * Same interface as IndexedPriorityQueue; keys are read from the workspace and must be
+ * integral and monotone (never below the last extracted key).
+ */
+class DialQueue {
+    SearchWorkspace &ws;
+    std::vector<std::vector<int>> buckets;
+    unsigned long long cursor = 0; // key of the current bucket
+    int live = 0;                  // vertices queued, ignoring stale entries
+    inline std::vector<int> &bucket(unsigned long long key);
+    void advance();
+public:
+    static constexpr unsigned MAX_BUCKETS = 1 << 16;
+
+    DialQueue(SearchWorkspace &ws, unsigned maxWeight);
+    void insert(int v);
+    int extractMin();
+    int peekMin();
+    void decreaseKey(int v);
+    bool empty();
+};
+
+inline DialQueue::DialQueue(SearchWorkspace &ws, unsigned maxWeight): ws(ws), buckets(maxWeight + 1) {
+}
+
+inline std::vector<int> &DialQueue::bucket(unsigned long long key) {
+    return buckets[key % buckets.size()];
+}
+
+inline bool DialQueue::empty() {
+    return live == 0;
+}
+
+inline void DialQueue::insert(int v) {
+    bucket(ws.getDist(v)).push_back(v);
+    live++;
+}
+
+inline void DialQueue::decreaseKey(int v) {
+    bucket(ws.getDist(v)).push_back(v);
+}
+
+/*
+ * Moves the cursor to the first bucket whose back entry is live. Requires !empty().
+ */
+inline void DialQueue::advance() {
+    while (true) {
+        auto &b = bucket(cursor);
+        while (!b.empty()) {
+            if (ws.getDist(b.back()) == cursor) return;
+            b.pop_back(); // stale: the vertex was filed again under a smaller key
+        }
+        cursor++;
+    }
+}
+
+inline int DialQueue::peekMin() {
+    advance();
+    return bucket(cursor).back();
+}
+
+inline int DialQueue::extractMin() {
+    advance();
+    auto &b = bucket(cursor);
+    int v = b.back();
+    b.pop_back();
+    live--;
+    return v;
+}
+
+#endif //DA_PROJECT1_DIALQUEUE_H
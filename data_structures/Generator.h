@@ -0,0 +1,94 @@
+#ifndef DA_PROJECT1_GENERATOR_H
+#define DA_PROJECT1_GENERATOR_H
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+/**
+ * Lazy sequence produced by a coroutine that co_yields values of type T (std::generator is
+ * only part of C++23).
+ *
+ * The coroutine starts suspended and runs up to its next co_yield each time the iterator
+ * advances, so a consumer that stops early never pays for the values it did not ask for.
+ * Arguments the coroutine takes by reference must outlive the generator. Single pass and
+ * move-only; an exception thrown inside the coroutine is rethrown to the consumer.
+ */
+template <class T>
+class Generator {
+public:
+    struct promise_type {
+        std::optional<T> current;
+        std::exception_ptr error;
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(T value) {
+            current = std::move(value);
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    class iterator {
+        Handle coroutine;
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(Handle coroutine): coroutine(coroutine) {}
+
+        T &operator*() const { return *coroutine.promise().current; }
+        T *operator->() const { return &*coroutine.promise().current; }
+        iterator &operator++() {
+            coroutine.promise().current.reset();
+            resume(coroutine);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(std::default_sentinel_t) const { return !coroutine || coroutine.done(); }
+    };
+
+    explicit Generator(Handle coroutine): coroutine(coroutine) {}
+    Generator(Generator &&other) noexcept: coroutine(std::exchange(other.coroutine, {})) {}
+    Generator &operator=(Generator &&other) noexcept {
+        if (this != &other) {
+            if (coroutine) coroutine.destroy();
+            coroutine = std::exchange(other.coroutine, {});
+        }
+        return *this;
+    }
+    Generator(const Generator &) = delete;
+    Generator &operator=(const Generator &) = delete;
+    ~Generator() {
+        if (coroutine) coroutine.destroy();
+    }
+
+    /*
+     * Runs the coroutine to its first value. Call once.
+     */
+    iterator begin() {
+        resume(coroutine);
+        return iterator(coroutine);
+    }
+    std::default_sentinel_t end() const { return {}; }
+
+protected:
+    Handle coroutine;
+
+    static void resume(Handle coroutine) {
+        if (!coroutine || coroutine.done()) return;
+        coroutine.resume();
+        if (coroutine.promise().error) std::rethrow_exception(std::exchange(coroutine.promise().error, {}));
+    }
+};
+
+#endif //DA_PROJECT1_GENERATOR_H
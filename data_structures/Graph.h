@@ -7,11 +7,14 @@
 
 #include <iostream>
 #include <vector>
+#include <span>
 #include <queue>
 #include <limits>
 #include <algorithm>
 #include <unordered_map> // [!] MODIFIED
+#include <type_traits>
 #include "../data_structures/MutablePriorityQueue.h" // not needed for now
+#include "../data_structures/ObjectPool.h"
 
 template <class T>
 class Edge;
@@ -23,23 +26,32 @@ class Edge;
 template <class T>
 class Vertex {
 public:
-    Vertex(T in);
+    /*
+     * Edges added to this vertex are placed in edgePool, or on the heap if it is null.
+     */
+    Vertex(T in, ObjectPool<Edge<T>> *edgePool = nullptr);
     bool operator<(Vertex<T> & vertex) const; // // required by MutablePriorityQueue
 
     T getInfo() const;
+    int getIndex() const;
     std::string getLocation() const; // [!] MODIFIED
     std::string getCode() const; // [!] MODIFIED
-    std::vector<Edge<T> *> getAdj() const;
+    /*
+     * Views of the outgoing and incoming edges, valid until an edge of this vertex is
+     * added or removed.
+     */
+    std::span<Edge<T> * const> getAdj() const;
     bool isVisited() const;
     bool isProcessing() const;
     int getParking() const; // [!] MODIFIED
     unsigned int getIndegree() const;
     double getDist() const;
     Edge<T> *getPath() const;
-    std::vector<Edge<T> *> getIncoming() const;
+    std::span<Edge<T> * const> getIncoming() const;
 
 
     void setInfo(T info);
+    void setIndex(int index);
     void setVisited(bool visited);
     void setProcessing(bool processing);
 
@@ -56,6 +68,11 @@ public:
     void setCode(std::string code); // [!] MODIFIED
     void setParking(int parking); // [!] MODIFIED
 
+    /*
+     * Heap bytes held by this vertex besides the object itself: edge lists and long strings.
+     */
+    size_t getHeapBytes() const;
+
     Edge<T> * addEdge(Vertex<T> *dest, double dw, double ww);
     bool removeEdge(T in);
     void removeOutgoingEdges();
@@ -63,6 +80,7 @@ public:
     friend class MutablePriorityQueue<Vertex>;
 protected:
     T info;                // info node
+    int index = -1;        // dense position in the owning graph's vertexSet
     std::string location; // [!] MODIFIED
     std::string code; // [!] MODIFIED
     std::vector<Edge<T> *> adj;  // outgoing edges
@@ -80,6 +98,8 @@ protected:
 
     int queueIndex = 0; 		// required by MutablePriorityQueue and UFDS
 
+    ObjectPool<Edge<T>> *edgePool; // owner of the outgoing edges (nullptr = heap)
+
     void deleteEdge(Edge<T> *edge);
 };
 
@@ -121,11 +141,29 @@ protected:
 template <class T>
 class Graph {
 public:
+    Graph() = default;
+    /*
+     * Frees every vertex and edge. Both live in slabs owned by the graph, so this releases
+     * them in bulk instead of one delete per object.
+     */
     ~Graph();
+    // Vertices and edges point into this graph's pools
+    Graph(const Graph &) = delete;
+    Graph &operator=(const Graph &) = delete;
+
     /*
     * Auxiliary function to find a vertex with a given the content.
     */
     Vertex<T> *findVertex(const T &in) const;
+    /*
+     * Finds the dense index (position in vertexSet) of the vertex with a given content, or -1.
+     * Constant time: backed by a content -> index hash map kept in sync by add/removeVertex.
+     */
+    int findVertexIdx(const T &in) const;
+    /*
+     * Returns the vertex at a given dense index (0 <= idx < getNumVertex()).
+     */
+    Vertex<T> *getVertex(int idx) const;
     /*
      *  Adds a vertex with a given content or info (in) to a graph (this).
      *  Returns true if successful, and false if a vertex with that content already exists.
@@ -143,38 +181,42 @@ public:
     bool addBidirectionalEdge(const T &sourc, const T &dest, double dw, double ww);
 
     int getNumVertex() const;
-    std::vector<Vertex<T> *> getVertexSet() const;
+    /*
+     * View of the vertices in dense index order, valid until a vertex is added or removed.
+     */
+    std::span<Vertex<T> * const> getVertexSet() const;
     int getIdFromCode(const std::string& code) const; // [!] MODIFIED
     void storeCode(const std::string& code, int id); // [!] MODIFIED
 
+    /*
+     * Approximate bytes held by the graph: vertex and edge slabs, edge lists, strings and the
+     * lookup tables (hash map nodes are estimated, not measured).
+     */
+    size_t getSizeBytes() const;
+
 protected:
     std::vector<Vertex<T> *> vertexSet;    // vertex set
 
-    double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall
-    int **pathMatrix = nullptr;   // path matrix for Floyd-Warshall
-
-    /*
-     * Finds the index of the vertex with a given content.
-     */
-    int findVertexIdx(const T &in) const;
     std::unordered_map<std::string, int> codeToId; // [!] MODIFIED
-};
+    std::unordered_map<T, int> infoToIdx; // vertex content -> dense index in vertexSet
 
-void deleteMatrix(int **m, int n);
-void deleteMatrix(double **m, int n);
+    // Storage of every vertex and edge; removed ones leave their slot for the next addition
+    ObjectPool<Vertex<T>> vertexPool;
+    ObjectPool<Edge<T>> edgePool;
+};
 
 
 /************************* Vertex  **************************/
 
 template <class T>
-Vertex<T>::Vertex(T in): info(in) {}
+Vertex<T>::Vertex(T in, ObjectPool<Edge<T>> *edgePool): info(in), edgePool(edgePool) {}
 /*
  * Auxiliary function to add an outgoing edge to a vertex (this),
  * with a given destination vertex (d) and edge weight (w).
  */
 template <class T>
 Edge<T> * Vertex<T>::addEdge(Vertex<T> *d, double dw, double ww) {
-    auto newEdge = new Edge<T>(this, d, dw, ww);
+    auto newEdge = edgePool ? edgePool->create(this, d, dw, ww) : new Edge<T>(this, d, dw, ww);
     adj.push_back(newEdge);
     d->incoming.push_back(newEdge);
     return newEdge;
@@ -227,6 +269,11 @@ T Vertex<T>::getInfo() const {
     return this->info;
 }
 
+template <class T>
+int Vertex<T>::getIndex() const {
+    return this->index;
+}
+
 template <class T>
 int Vertex<T>::getLow() const {
     return this->low;
@@ -248,7 +295,7 @@ void Vertex<T>::setNum(int value) {
 }
 
 template <class T>
-std::vector<Edge<T>*> Vertex<T>::getAdj() const {
+std::span<Edge<T> * const> Vertex<T>::getAdj() const {
     return this->adj;
 }
 
@@ -278,7 +325,7 @@ Edge<T> *Vertex<T>::getPath() const {
 }
 
 template <class T>
-std::vector<Edge<T> *> Vertex<T>::getIncoming() const {
+std::span<Edge<T> * const> Vertex<T>::getIncoming() const {
     return this->incoming;
 }
 
@@ -305,6 +352,11 @@ void Vertex<T>::setInfo(T in) {
     this->info = in;
 }
 
+template <class T>
+void Vertex<T>::setIndex(int index) {
+    this->index = index;
+}
+
 template <class T>
 void Vertex<T>::setVisited(bool visited) {
     this->visited = visited;
@@ -348,6 +400,20 @@ void Vertex<T>::setParking(int parking) {
     this->parking = parking;
 }
 
+/*
+ * Heap bytes behind a string; short strings are stored inside the object and count as none.
+ */
+inline size_t stringHeapBytes(const std::string &text) {
+    auto inside = reinterpret_cast<const char *>(&text);
+    bool local = text.data() >= inside && text.data() < inside + sizeof(text);
+    return local ? 0 : text.capacity() + 1;
+}
+
+template <class T>
+size_t Vertex<T>::getHeapBytes() const {
+    return (adj.capacity() + incoming.capacity()) * sizeof(Edge<T> *) + stringHeapBytes(location) + stringHeapBytes(code);
+}
+
 template <class T>
 void Vertex<T>::deleteEdge(Edge<T> *edge) {
     Vertex<T> *dest = edge->getDest();
@@ -361,7 +427,8 @@ void Vertex<T>::deleteEdge(Edge<T> *edge) {
             it++;
         }
     }
-    delete edge;
+    if (edgePool) edgePool->destroy(edge);
+    else delete edge;
 }
 
 /********************** Edge  ****************************/
@@ -421,13 +488,22 @@ void Edge<T>::setFlow(double flow) {
 
 /********************** Graph  ****************************/
 
+template <class T>
+Graph<T>::~Graph() {
+    // Edges hold no resources, so their slabs go without visiting them
+    static_assert(std::is_trivially_destructible_v<Edge<T>>, "edges are released without destructor calls");
+    for (auto v : vertexSet) {
+        vertexPool.destroy(v);
+    }
+}
+
 template <class T>
 int Graph<T>::getNumVertex() const {
     return vertexSet.size();
 }
 
 template <class T>
-std::vector<Vertex<T> *> Graph<T>::getVertexSet() const {
+std::span<Vertex<T> * const> Graph<T>::getVertexSet() const {
     return vertexSet;
 }
 
@@ -436,10 +512,8 @@ std::vector<Vertex<T> *> Graph<T>::getVertexSet() const {
  */
 template <class T>
 Vertex<T> * Graph<T>::findVertex(const T &in) const {
-    for (auto v : vertexSet)
-        if (v->getInfo() == in)
-            return v;
-    return nullptr;
+    int idx = findVertexIdx(in);
+    return idx == -1 ? nullptr : vertexSet[idx];
 }
 
 /*
@@ -447,11 +521,16 @@ Vertex<T> * Graph<T>::findVertex(const T &in) const {
  */
 template <class T>
 int Graph<T>::findVertexIdx(const T &in) const {
-    for (unsigned i = 0; i < vertexSet.size(); i++)
-        if (vertexSet[i]->getInfo() == in)
-            return i;
+    auto it = infoToIdx.find(in);
+    if (it != infoToIdx.end())
+        return it->second;
     return -1;
 }
+template <class T>
+Vertex<T> * Graph<T>::getVertex(int idx) const {
+    return vertexSet[idx];
+}
+
 /*
  *  Adds a vertex with a given content or info (in) to a graph (this).
  *  Returns true if successful, and false if a vertex with that content already exists.
@@ -460,7 +539,10 @@ template <class T>
 bool Graph<T>::addVertex(const T &in) {
     if (findVertex(in) != nullptr)
         return false;
-    vertexSet.push_back(new Vertex<T>(in));
+    auto v = vertexPool.create(in, &edgePool);
+    v->setIndex(vertexSet.size());
+    infoToIdx[in] = vertexSet.size();
+    vertexSet.push_back(v);
     return true;
 }
 
@@ -471,19 +553,23 @@ bool Graph<T>::addVertex(const T &in) {
  */
 template <class T>
 bool Graph<T>::removeVertex(const T &in) {
-    for (auto it = vertexSet.begin(); it != vertexSet.end(); it++) {
-        if ((*it)->getInfo() == in) {
-            auto v = *it;
-            v->removeOutgoingEdges();
-            for (auto u : vertexSet) {
-                u->removeEdge(v->getInfo());
-            }
-            vertexSet.erase(it);
-            delete v;
-            return true;
-        }
+    int idx = findVertexIdx(in);
+    if (idx == -1)
+        return false;
+    auto v = vertexSet[idx];
+    v->removeOutgoingEdges();
+    for (auto u : vertexSet) {
+        u->removeEdge(v->getInfo());
     }
-    return false;
+    vertexSet.erase(vertexSet.begin() + idx);
+    infoToIdx.erase(in);
+    // keep the dense indices contiguous for the vertices that shifted down
+    for (unsigned i = idx; i < vertexSet.size(); i++) {
+        vertexSet[i]->setIndex(i);
+        infoToIdx[vertexSet[i]->getInfo()] = i;
+    }
+    vertexPool.destroy(v);
+    return true;
 }
 
 /*
@@ -544,28 +630,19 @@ void Graph<T>::storeCode(const std::string& code, int id) {
     codeToId[code] = id;
 }
 
-inline void deleteMatrix(int **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
+template <class T>
+size_t Graph<T>::getSizeBytes() const {
+    size_t bytes = vertexPool.capacityBytes() + edgePool.capacityBytes() + vertexSet.capacity() * sizeof(Vertex<T> *);
+    for (auto v : vertexSet) {
+        bytes += v->getHeapBytes();
     }
-}
-
-inline void deleteMatrix(double **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
+    // Each hash map node holds its pair and a next pointer; the bucket array holds one pointer per bucket
+    for (auto &[code, id] : codeToId) {
+        bytes += sizeof(void *) + sizeof(std::pair<const std::string, int>) + stringHeapBytes(code);
     }
-}
-
-template <class T>
-Graph<T>::~Graph() {
-    deleteMatrix(distMatrix, vertexSet.size());
-    deleteMatrix(pathMatrix, vertexSet.size());
+    bytes += codeToId.bucket_count() * sizeof(void *);
+    bytes += infoToIdx.size() * (sizeof(void *) + sizeof(std::pair<const T, int>)) + infoToIdx.bucket_count() * sizeof(void *);
+    return bytes;
 }
 
 #endif //DA_PROJECT1_GRAPH_H
@@ -0,0 +1,94 @@
+#ifndef DA_PROJECT1_INDEXEDPRIORITYQUEUE_H
+#define DA_PROJECT1_INDEXEDPRIORITYQUEUE_H
+
+#include <vector>
+#include "SearchWorkspace.h"
+
+/**
+ * Same binary heap as MutablePriorityQueue, but over dense vertex indices: keys are read from
+ * the workspace's dist array and heap positions are written to its heap-index array, so the
+ * graph itself is never touched.
+ */
+class IndexedPriorityQueue {
+    SearchWorkspace &ws;
+    std::vector<int> H;
+    void heapifyUp(unsigned i);
+    void heapifyDown(unsigned i);
+    inline void set(unsigned i, int v);
+    inline bool less(int a, int b) const;
+public:
+    explicit IndexedPriorityQueue(SearchWorkspace &ws);
+    void insert(int v);
+    int extractMin();
+    int peekMin() const;
+    void decreaseKey(int v);
+    bool empty();
+};
+
+inline IndexedPriorityQueue::IndexedPriorityQueue(SearchWorkspace &ws): ws(ws) {
+    H.push_back(-1);
+    // indices will be used starting in 1
+    // to facilitate parent/child calculations
+}
+
+inline bool IndexedPriorityQueue::empty() {
+    return H.size() == 1;
+}
+
+inline int IndexedPriorityQueue::extractMin() {
+    auto x = H[1];
+    H[1] = H.back();
+    H.pop_back();
+    if (H.size() > 1) heapifyDown(1);
+    ws.setHeapIndex(x, 0);
+    return x;
+}
+
+inline int IndexedPriorityQueue::peekMin() const {
+    return H[1];
+}
+
+inline void IndexedPriorityQueue::insert(int v) {
+    H.push_back(v);
+    heapifyUp(H.size() - 1);
+}
+
+inline void IndexedPriorityQueue::decreaseKey(int v) {
+    heapifyUp(ws.getHeapIndex(v));
+}
+
+inline void IndexedPriorityQueue::heapifyUp(unsigned i) {
+    auto x = H[i];
+    while (i > 1 && less(x, H[i / 2])) {
+        set(i, H[i / 2]);
+        i = i / 2;
+    }
+    set(i, x);
+}
+
+inline void IndexedPriorityQueue::heapifyDown(unsigned i) {
+    auto x = H[i];
+    while (true) {
+        unsigned k = i * 2;
+        if (k >= H.size())
+            break;
+        if (k + 1 < H.size() && less(H[k + 1], H[k]))
+            ++k; // right child of i
+        if (!less(H[k], x))
+            break;
+        set(i, H[k]);
+        i = k;
+    }
+    set(i, x);
+}
+
+inline void IndexedPriorityQueue::set(unsigned i, int v) {
+    H[i] = v;
+    ws.setHeapIndex(v, i);
+}
+
+inline bool IndexedPriorityQueue::less(int a, int b) const {
+    return ws.getDist(a) < ws.getDist(b);
+}
+
+#endif //DA_PROJECT1_INDEXEDPRIORITYQUEUE_H
@@ -0,0 +1,102 @@
+#ifndef DA_PROJECT1_OBJECTPOOL_H
+#define DA_PROJECT1_OBJECTPOOL_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstddef>
+
+/**
+ * Slab allocator for objects of a single type.
+ *
+ * Objects are constructed in place inside slabs of SlabSize slots, so objects created one
+ * after another sit next to each other in memory. destroy() runs the destructor and puts the
+ * slot on a free list, which create() reuses before taking a fresh slot. All slabs are
+ * released together when the pool is destroyed; objects still alive at that point are NOT
+ * destroyed, so an owner of non-trivially destructible objects destroys them first.
+ */
+template <class T, size_t SlabSize = 1024>
+class ObjectPool {
+    static_assert(SlabSize > 0, "a slab needs at least one slot");
+public:
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    /*
+     * Constructs a T from args in a recycled or fresh slot.
+     */
+    template <class... Args>
+    T *create(Args &&... args);
+    /*
+     * Destroys an object returned by create() of this pool and recycles its slot.
+     */
+    void destroy(T *object);
+
+    /*
+     * Number of objects created and not yet destroyed.
+     */
+    size_t size() const;
+    /*
+     * Bytes held by the slabs, live or free.
+     */
+    size_t capacityBytes() const;
+
+protected:
+    union Slot {
+        Slot *next;                                  // while on the free list
+        alignas(T) unsigned char storage[sizeof(T)]; // while holding an object
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    Slot *freeList = nullptr;
+    size_t used = SlabSize; // slots taken from the last slab
+    size_t live = 0;
+};
+
+template <class T, size_t SlabSize>
+template <class... Args>
+T *ObjectPool<T, SlabSize>::create(Args &&... args) {
+    Slot *slot;
+    if (freeList != nullptr) {
+        slot = freeList;
+        freeList = slot->next;
+    } else {
+        if (used == SlabSize) {
+            slabs.emplace_back(new Slot[SlabSize]);
+            used = 0;
+        }
+        slot = &slabs.back()[used++];
+    }
+    try {
+        T *object = new (slot->storage) T(std::forward<Args>(args)...);
+        live++;
+        return object;
+    } catch (...) {
+        slot->next = freeList;
+        freeList = slot;
+        throw;
+    }
+}
+
+template <class T, size_t SlabSize>
+void ObjectPool<T, SlabSize>::destroy(T *object) {
+    object->~T();
+    auto slot = reinterpret_cast<Slot *>(object);
+    slot->next = freeList;
+    freeList = slot;
+    live--;
+}
+
+template <class T, size_t SlabSize>
+size_t ObjectPool<T, SlabSize>::size() const {
+    return live;
+}
+
+template <class T, size_t SlabSize>
+size_t ObjectPool<T, SlabSize>::capacityBytes() const {
+    return slabs.size() * SlabSize * sizeof(Slot);
+}
+
+#endif //DA_PROJECT1_OBJECTPOOL_H
@@ -0,0 +1,102 @@
+#ifndef DA_PROJECT1_RADIXHEAP_H
+#define DA_PROJECT1_RADIXHEAP_H
+
+#include <vector>
+#include <utility>
+#include <bit>
+#include "SearchWorkspace.h"
+
+/**
+ * Radix heap for Dijkstra over non-negative integer weights of any size.
+ *
+ * Entries are filed by the highest bit in which their key differs from the last extracted
+ * key, so bucket 0 holds keys equal to it and bucket i keys in [2^(i-1), 2^i) above it.
+ * When bucket 0 runs dry the first non-empty bucket is redistributed around its minimum;
+ * every entry only moves to lower buckets, which makes each operation O(log C) amortized
+ * for a maximum key C. Like DialQueue, decreaseKey() files the vertex again and the old
+ * entry is dropped as stale when it is met.
+ *
+ * Same interface as IndexedPriorityQueue; keys are read from the workspace and must be
+ * integral and monotone.
+ */
+class RadixHeap {
+    SearchWorkspace &ws;
+    std::vector<std::pair<unsigned long long, int>> buckets[65];
+    unsigned long long last = 0;
+    int live = 0;
+    inline void push(unsigned long long key, int v);
+    inline bool isStale(const std::pair<unsigned long long, int> &entry) const;
+    void refill();
+public:
+    explicit RadixHeap(SearchWorkspace &ws);
+    void insert(int v);
+    int extractMin();
+    int peekMin();
+    void decreaseKey(int v);
+    bool empty();
+};
+
+inline RadixHeap::RadixHeap(SearchWorkspace &ws): ws(ws) {
+}
+
+inline bool RadixHeap::empty() {
+    return live == 0;
+}
+
+inline void RadixHeap::push(unsigned long long key, int v) {
+    buckets[std::bit_width(key ^ last)].emplace_back(key, v);
+}
+
+inline bool RadixHeap::isStale(const std::pair<unsigned long long, int> &entry) const {
+    return entry.first != (unsigned long long) ws.getDist(entry.second);
+}
+
+inline void RadixHeap::insert(int v) {
+    push(ws.getDist(v), v);
+    live++;
+}
+
+inline void RadixHeap::decreaseKey(int v) {
+    push(ws.getDist(v), v);
+}
+
+/*
+ * Makes the back of bucket 0 a live entry holding the minimum key. Requires !empty().
+ */
+inline void RadixHeap::refill() {
+    while (true) {
+        auto &front = buckets[0];
+        while (!front.empty() && isStale(front.back())) front.pop_back();
+        if (!front.empty()) return;
+
+        int i = 1;
+        while (buckets[i].empty()) i++;
+        auto moved = std::move(buckets[i]);
+        buckets[i].clear();
+
+        bool found = false;
+        for (auto &entry : moved) {
+            if (isStale(entry)) continue;
+            if (!found || entry.first < last) last = entry.first;
+            found = true;
+        }
+        for (auto &entry : moved) {
+            if (!isStale(entry)) push(entry.first, entry.second);
+        }
+    }
+}
+
+inline int RadixHeap::peekMin() {
+    refill();
+    return buckets[0].back().second;
+}
+
+inline int RadixHeap::extractMin() {
+    refill();
+    int v = buckets[0].back().second;
+    buckets[0].pop_back();
+    live--;
+    return v;
+}
+
+#endif //DA_PROJECT1_RADIXHEAP_H
@@ -0,0 +1,34 @@
+#ifndef DA_PROJECT1_SEARCHQUEUE_H
+#define DA_PROJECT1_SEARCHQUEUE_H
+
+#include "CsrGraph.h"
+#include "SearchWorkspace.h"
+#include "DaryHeap.h"
+#include "DialQueue.h"
+#include "RadixHeap.h"
+
+/**
+ * Picks the priority queue for Dijkstra-style searches over a snapshot and calls
+ * fn(makeQueue), where makeQueue(ws) returns a queue keyed on ws:
+ * - DialQueue if every weight is an integer no larger than DialQueue::MAX_BUCKETS,
+ * - RadixHeap for larger integer weights,
+ * - a 4-ary DaryHeap otherwise (see HeapBenchmark for the arity comparison).
+ * All three share insert / extractMin / peekMin / decreaseKey / empty, so fn is written once
+ * (as a generic lambda) and instantiated per queue type.
+ *
+ * The integer queues require monotone keys: plain Dijkstra distances qualify, A* keys and
+ * sums of contracted shortcuts use DaryHeap directly.
+ */
+template <class Fn>
+decltype(auto) withSearchQueue(const CsrGraph &graph, Fn &&fn) {
+    if (graph.hasIntegralWeights() && graph.getMaxWeight() <= DialQueue::MAX_BUCKETS) {
+        unsigned maxWeight = graph.getMaxWeight();
+        return fn([maxWeight](SearchWorkspace &ws) { return DialQueue(ws, maxWeight); });
+    }
+    if (graph.hasIntegralWeights()) {
+        return fn([](SearchWorkspace &ws) { return RadixHeap(ws); });
+    }
+    return fn([](SearchWorkspace &ws) { return DaryHeap<4>(ws); });
+}
+
+#endif //DA_PROJECT1_SEARCHQUEUE_H
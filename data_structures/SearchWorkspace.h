@@ -0,0 +1,129 @@
+#ifndef DA_PROJECT1_SEARCHWORKSPACE_H
+#define DA_PROJECT1_SEARCHWORKSPACE_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#ifndef INF
+#define INF std::numeric_limits<double>::max()
+#endif
+
+/**
+ * Query-local state of a shortest-path search (dist, parent and heap position per dense
+ * vertex index), kept outside the graph so one loaded graph can serve many queries at once.
+ *
+ * Every entry carries the generation it was written in; reset() just bumps the generation,
+ * so starting a new search costs O(1) instead of an O(V) clearing loop. Entries from older
+ * generations read as dist = INF, parent = -1, heap index = 0.
+ *
+ * A workspace is not thread-safe: use one per thread (see forThread()).
+ */
+class SearchWorkspace {
+public:
+    explicit SearchWorkspace(int numVertex = 0);
+
+    /*
+     * Starts a new search over a graph with numVertex vertices, growing the arrays if needed.
+     */
+    void reset(int numVertex);
+
+    bool isReached(int v) const;
+    double getDist(int v) const;
+    int getParent(int v) const;
+    int getHeapIndex(int v) const;
+
+    void setDist(int v, double dist);
+    void setParent(int v, int parent);
+    void setHeapIndex(int v, int heapIndex);
+
+    /*
+     * Bytes held for the vertices this workspace has been sized for.
+     */
+    size_t getSizeBytes() const;
+
+    /*
+     * Workspace owned by the calling thread; slot distinguishes the independent searches a
+     * single query may need at the same time (e.g. driving and walking trees).
+     */
+    static SearchWorkspace &forThread(int slot = 0);
+
+protected:
+    std::vector<double> dist;
+    std::vector<int> parent;
+    std::vector<int> heapIndex; // required by IndexedPriorityQueue and DaryHeap, 0 = not queued
+    std::vector<unsigned> stamp;
+    unsigned generation = 1;
+
+    void touch(int v);
+};
+
+inline SearchWorkspace::SearchWorkspace(int numVertex) {
+    reset(numVertex);
+}
+
+inline void SearchWorkspace::reset(int numVertex) {
+    if ((int) stamp.size() < numVertex) {
+        dist.resize(numVertex);
+        parent.resize(numVertex);
+        heapIndex.resize(numVertex);
+        stamp.resize(numVertex, 0);
+    }
+    if (++generation == 0) {
+        // wrapped around: stale stamps could now look current
+        std::fill(stamp.begin(), stamp.end(), 0);
+        generation = 1;
+    }
+}
+
+inline bool SearchWorkspace::isReached(int v) const {
+    return stamp[v] == generation;
+}
+
+inline double SearchWorkspace::getDist(int v) const {
+    return stamp[v] == generation ? dist[v] : INF;
+}
+
+inline int SearchWorkspace::getParent(int v) const {
+    return stamp[v] == generation ? parent[v] : -1;
+}
+
+inline int SearchWorkspace::getHeapIndex(int v) const {
+    return stamp[v] == generation ? heapIndex[v] : 0;
+}
+
+inline void SearchWorkspace::setDist(int v, double d) {
+    touch(v);
+    dist[v] = d;
+}
+
+inline void SearchWorkspace::setParent(int v, int p) {
+    touch(v);
+    parent[v] = p;
+}
+
+inline void SearchWorkspace::setHeapIndex(int v, int i) {
+    touch(v);
+    heapIndex[v] = i;
+}
+
+inline size_t SearchWorkspace::getSizeBytes() const {
+    return dist.capacity() * sizeof(double) + (parent.capacity() + heapIndex.capacity()) * sizeof(int)
+         + stamp.capacity() * sizeof(unsigned);
+}
+
+inline void SearchWorkspace::touch(int v) {
+    if (stamp[v] != generation) {
+        stamp[v] = generation;
+        dist[v] = INF;
+        parent[v] = -1;
+        heapIndex[v] = 0;
+    }
+}
+
+inline SearchWorkspace &SearchWorkspace::forThread(int slot) {
+    thread_local SearchWorkspace workspaces[2];
+    return workspaces[slot];
+}
+
+#endif //DA_PROJECT1_SEARCHWORKSPACE_H
@@ -0,0 +1,125 @@
+#ifndef DA_PROJECT1_THREADPOOL_H
+#define DA_PROJECT1_THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+/**
+ * Fixed set of worker threads that run data-parallel loops.
+ * parallelFor() hands out loop indices dynamically, so uneven work items (e.g. a mix of cheap
+ * and expensive route queries) still balance across workers. Each call also passes the id of
+ * the worker running the item, which callers use to pick per-worker state such as search
+ * workspaces. Calls are serialized; body must not call parallelFor() on the same pool.
+ */
+class ThreadPool {
+public:
+    /*
+     * numThreads == 0 picks one worker per hardware thread. A pool of one starts no thread and
+     * runs parallelFor() on the calling thread, so code already running on a worker can ask for
+     * a serial loop without spawning threads of its own.
+     */
+    explicit ThreadPool(unsigned numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned size() const;
+
+    /*
+     * Runs body(i, worker) for every i in [0, count), worker in [0, size()), and blocks until
+     * all items are done. The first exception thrown by body is rethrown here.
+     */
+    void parallelFor(int count, const std::function<void(int, unsigned)> &body);
+
+protected:
+    std::vector<std::thread> workers;   // empty for a pool of one
+    std::mutex runMutex;   // one parallelFor at a time
+    std::mutex mutex;      // guards the job fields below
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(int, unsigned)> *job = nullptr;
+    int jobCount = 0;
+    unsigned jobId = 0;
+    unsigned pending = 0;
+    bool stopping = false;
+    std::atomic<int> next{0};
+    std::exception_ptr error;
+
+    void workerLoop(unsigned id);
+};
+
+inline ThreadPool::ThreadPool(unsigned numThreads) {
+    if (numThreads == 0) numThreads = std::thread::hardware_concurrency();
+    if (numThreads <= 1) return;
+    for (unsigned i = 0; i < numThreads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &t : workers) t.join();
+}
+
+inline unsigned ThreadPool::size() const {
+    return workers.empty() ? 1 : workers.size();
+}
+
+inline void ThreadPool::parallelFor(int count, const std::function<void(int, unsigned)> &body) {
+    if (count <= 0) return;
+    if (workers.empty()) {
+        for (int i = 0; i < count; i++) body(i, 0);
+        return;
+    }
+    std::lock_guard<std::mutex> run(runMutex);
+    std::unique_lock<std::mutex> lock(mutex);
+    job = &body;
+    jobCount = count;
+    next = 0;
+    error = nullptr;
+    pending = workers.size();
+    ++jobId;
+    wake.notify_all();
+    done.wait(lock, [this] { return pending == 0; });
+    job = nullptr;
+    if (error) std::rethrow_exception(error);
+}
+
+inline void ThreadPool::workerLoop(unsigned id) {
+    unsigned seen = 0;
+    while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&] { return stopping || jobId != seen; });
+        if (stopping) return;
+        seen = jobId;
+        auto body = job;
+        int count = jobCount;
+        lock.unlock();
+
+        try {
+            for (int i; (i = next.fetch_add(1)) < count; ) {
+                (*body)(i, id);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (!error) error = std::current_exception();
+            next = count; // stop handing out work
+        }
+
+        lock.lock();
+        if (--pending == 0) done.notify_all();
+    }
+}
+
+#endif //DA_PROJECT1_THREADPOOL_H
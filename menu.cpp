@@ -6,6 +6,7 @@
 #include <limits>
 #include <fstream>
 #include <filesystem>
+#include <cstdlib>
 #include "menu.h"
 #include "reader.h"
 #include "cmake-build-debug/batch/batch.h"
@@ -14,9 +15,26 @@
 #include "data_structures/Graph.h"
 #include "EnvFriendlyRoute.h"
 #include "AlternativeRoute.h"
+#include "ParetoRoute.h"
+#include "DrivingAlternatives.h"
+#include "KShortestPaths.h"
+#include "MultimodalRoute.h"
+#include "BatchEngine.h"
+#include "HeapBenchmark.h"
+#include "DistanceTable.h"
+#include "GraphSnapshot.h"
+#include "CsvLoader.h"
+#include "MemoryReport.h"
+#include <chrono>
 
 using namespace std;
 
+const string LOCATIONS_FILE = "../mock_csv_data/Locations.csv";
+const string DISTANCES_FILE = "../mock_csv_data/Distances.csv";
+// Files written by the Tools menu and mapped again on start-up
+const string DISTANCE_TABLE_FILE = "distance_table.bin";
+const string GRAPH_SNAPSHOT_FILE = "graph_snapshot.bin";
+
 // ----------------------------------------------------------
 // HELPER FUNCTIONS FOR USER INPUT
 // ----------------------------------------------------------
@@ -227,7 +245,8 @@ void displayMainMenu() {
     cout << "\n===== Route Planning Tool =====\n";
     cout << "1. Driving Only\n";
     cout << "2. Driving and Walking\n";
-    cout << "3. Exit\n";
+    cout << "3. Tools\n";
+    cout << "4. Exit\n";
     // no immediate prompt here because we handle input with readIntChoice
 }
 
@@ -235,14 +254,28 @@ void displayDrivingMenu() {
     cout << "\n===== Driving Only Functions =====\n";
     cout << "1. Find Best Route\n";
     cout << "2. Find Restricted Route\n";
-    cout << "3. Back to Main Menu\n";
+    cout << "3. Find Alternative Routes\n";
+    cout << "4. Find k Shortest Routes\n";
+    cout << "5. Back to Main Menu\n";
 }
 
 void displayDrivingWalkingMenu() {
     cout << "\n===== Driving and Walking Functions =====\n";
     cout << "1. Find Best Driving and Walking Route\n";
     cout << "2. Find aproximate solution\n";
-    cout << "3. Back to Main Menu\n";
+    cout << "3. Compare walking and total time trade-offs\n";
+    cout << "4. Find Best Driving and Walking Route (layered search)\n";
+    cout << "5. Back to Main Menu\n";
+}
+
+void displayToolsMenu() {
+    cout << "\n===== Tools =====\n";
+    cout << "1. Benchmark Priority Queues\n";
+    cout << "2. Build Distance Table\n";
+    cout << "3. Export Graph Snapshot\n";
+    cout << "4. Benchmark CSV Loading\n";
+    cout << "5. Memory Footprint Report\n";
+    cout << "6. Back to Main Menu\n";
 }
 
 // ----------------------------------------------------------
@@ -251,13 +284,14 @@ void displayDrivingWalkingMenu() {
 
 /**
  * Handles the Driving-Only sub-menu logic.
- * Loops until user chooses option 3 (Back to Main Menu).
+ * Loops until user chooses option 5 (Back to Main Menu).
  */
-void handleDrivingSubMenu(Graph<int>& graph) {
+void handleDrivingSubMenu(Graph<int>& graph, const CsrGraph& csr, const ContractionHierarchy& ch,
+                          const LandmarkIndex& landmarks, const DistanceTable* table) {
     while (true) {
         displayDrivingMenu();
-        // only accept 1, 2, or 3
-        int subVal = readIntChoice("Enter your choice: ", {1, 2, 3});
+        // only accept 1 to 5
+        int subVal = readIntChoice("Enter your choice: ", {1, 2, 3, 4, 5});
 
         switch (subVal) {
             case 1: {
@@ -270,8 +304,9 @@ void handleDrivingSubMenu(Graph<int>& graph) {
                     cout << "Destination must be different from source. Try again.\n";
                 }
                 double bestTime, altTime;
-                auto bestPath = findBestRoute(graph, source, destination, bestTime);
-                auto altPath = bestPath.empty() ? std::vector<int>() : findAlternativeRoute(graph, source, destination, bestPath, altTime);
+                auto bestPath = table ? table->findBestRoute(source, destination, bestTime)
+                                      : ch.findBestRoute(source, destination, bestTime);
+                auto altPath = bestPath.empty() ? std::vector<int>() : findAlternativeRoute(csr, source, destination, bestPath, altTime);
 
                 cout << "Source:" << source << "\n";
                 cout << "Destination:" << destination << "\n";
@@ -327,7 +362,7 @@ void handleDrivingSubMenu(Graph<int>& graph) {
                 }
 
                 cout << "Finding Restricted Driving Route...\n";
-                auto path = restrictedDrivingRoute(graph, source, destination, avoidNodes, avoidSegs, includeNode);
+                auto path = landmarks.restrictedDrivingRoute(source, destination, avoidNodes, avoidSegs, includeNode);
                 if (path.empty()) {
                     cout << "RestrictedDrivingRoute:none\n";
                 } else {
@@ -350,7 +385,66 @@ void handleDrivingSubMenu(Graph<int>& graph) {
                 }
                 break;
             }
-            case 3:
+            case 3: {
+                cout << "\n--- Alternative Driving Routes ---\n";
+                int source = readAnyInteger("Enter Source ID: ", graph);
+                int destination;
+                while (true) {
+                    destination = readAnyInteger("Enter Destination ID: ", graph);
+                    if (destination != source) break;
+                    cout << "Destination must be different from source. Try again.\n";
+                }
+                int k = readIntChoice("Number of alternatives (1-5): ", {1, 2, 3, 4, 5});
+
+                cout << "Finding Alternative Driving Routes...\n";
+                auto routes = findDrivingAlternatives(csr, source, destination, k);
+                if (routes.empty()) {
+                    cout << "BestDrivingRoute:none\n";
+                    cout << "AlternativeDrivingRoute:none\n";
+                    break;
+                }
+                for (size_t r = 0; r < routes.size(); ++r) {
+                    if (r == 0) cout << "BestDrivingRoute:";
+                    else cout << "AlternativeDrivingRoute" << r << ":";
+                    for (size_t i = 0; i < routes[r].path.size(); ++i) {
+                        cout << routes[r].path[i];
+                        if (i != routes[r].path.size() - 1) cout << ",";
+                    }
+                    cout << "(" << routes[r].time << ")";
+                    if (r > 0) cout << " via " << routes[r].viaNode << ", shared " << routes[r].sharedTime;
+                    cout << "\n";
+                }
+                if (routes.size() == 1) cout << "AlternativeDrivingRoute:none\n";
+                break;
+            }
+            case 4: {
+                cout << "\n--- k Shortest Driving Routes ---\n";
+                int source = readAnyInteger("Enter Source ID: ", graph);
+                int destination;
+                while (true) {
+                    destination = readAnyInteger("Enter Destination ID: ", graph);
+                    if (destination != source) break;
+                    cout << "Destination must be different from source. Try again.\n";
+                }
+                // Counted like the batch Alternatives: field, i.e. routes after the best one
+                int k = readIntChoice("Number of alternatives (1-9): ", {1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+                cout << "Finding k Shortest Driving Routes...\n";
+                ThreadPool pool;
+                int rank = 0;
+                for (auto &route : kShortestPaths(csr, source, destination, {}, {}, &pool)) {
+                    cout << "DrivingRoute" << ++rank << ":";
+                    for (size_t i = 0; i < route.path.size(); ++i) {
+                        cout << route.path[i];
+                        if (i != route.path.size() - 1) cout << ",";
+                    }
+                    cout << "(" << route.time << ")\n";
+                    if (rank > k) break;
+                }
+                if (rank == 0) cout << "DrivingRoute:none\n";
+                break;
+            }
+            case 5:
                 cout << "Returning to Main Menu...\n";
                 return; // exit this sub-menu
         }
@@ -359,16 +453,19 @@ void handleDrivingSubMenu(Graph<int>& graph) {
 
 /**
  * Handles the Driving+Walking sub-menu logic.
- * Loops until user chooses option 3 (Back to Main Menu).
+ * Loops until user chooses option 5 (Back to Main Menu).
  */
-void handleDrivingWalkingSubMenu(Graph<int>& graph) {
+void handleDrivingWalkingSubMenu(Graph<int>& graph, const CsrGraph& csr, const LandmarkIndex& landmarks,
+                                 const DistanceTable* table) {
     while (true) {
         displayDrivingWalkingMenu();
-        int subVal = readIntChoice("Enter your choice: ", {1, 2, 3, 4});
+        int subVal = readIntChoice("Enter your choice: ", {1, 2, 3, 4, 5});
 
         switch (subVal) {
-            case 1: {
-                cout << "\n--- Environmentally-Friendly Route ---\n";
+            case 1:
+            case 4: {
+                // Same query and output; option 4 answers it with the single layered search
+                cout << "\n--- Environmentally-Friendly Route" << (subVal == 4 ? " (layered search)" : "") << " ---\n";
                 int source; int destination;
                 while (true) {
                     source = readAnyInteger("Enter Source ID: ", graph);
@@ -387,7 +484,13 @@ void handleDrivingWalkingSubMenu(Graph<int>& graph) {
                 }
                 auto avoidSegs  = readSegments("Enter Segments to Avoid (format: (id1,id2) space-separated, blank if none): ", graph);
 
-                EnvFriendlyRoute route = findEnvFriendlyRoute(graph, source, destination, maxWalk, avoidNodes, avoidSegs);
+                // The table holds distances without avoid lists, like in batch mode
+                bool plain = avoidNodes.empty() && avoidSegs.empty();
+                EnvFriendlyRoute route = subVal == 4
+                        ? findMultimodalRoute(csr, source, destination, maxWalk, avoidNodes, avoidSegs, &landmarks)
+                        : table && plain
+                        ? table->findEnvFriendlyRoute(source, destination, maxWalk)
+                        : landmarks.findEnvFriendlyRoute(source, destination, maxWalk, avoidNodes, avoidSegs);
 
 
                 cout << "Source:" << source << "\n";
@@ -444,7 +547,7 @@ void handleDrivingWalkingSubMenu(Graph<int>& graph) {
                 auto avoidSegs  = readSegments("Enter Segments to Avoid (format: (id1,id2), space-separated, blank if none): ", graph);
 
                 // Fetch alternative routes
-                auto alternatives = AlternativeRoute::findTwoSolutions(graph, source, destination, maxWalk, avoidNodes, avoidSegs);
+                auto alternatives = AlternativeRoute::findTwoSolutions(csr, source, destination, maxWalk, avoidNodes, avoidSegs);
 
                 if (!alternatives.empty()) {
                     cout << "Source:" << source << "\n";
@@ -474,167 +577,131 @@ void handleDrivingWalkingSubMenu(Graph<int>& graph) {
                 break;
             }
 
-            case 3:
-                cout << "Returning to Main Menu...\n";
-                return; // exit sub-menu
-        }
-    }
-}
-
-// ----------------------------------------------------------
-// BATCH MODE
-// ----------------------------------------------------------
-
-void runBatchMode(Graph<int>& graph) {
-    ifstream inFile("batch/input.txt");
-    ofstream outFile("batch/output.txt");
-    if (!inFile.is_open() || !outFile.is_open()) return;
-
-    string line;
-    while (getline(inFile, line)) {
-        if (line.starts_with("Mode:")) {
-            string mode = line.substr(5);
-
-            // Shared variables
-            int source = -1, destination = -1, includeNode = -1;
-            double maxWalk = 0;
-            vector<int> avoidNodes;
-            vector<pair<int, int>> avoidSegs;
-
-            // Read block
-            while (getline(inFile, line) && !line.starts_with("---")) {
-                if (line.starts_with("Source:")) {
-                    source = stoi(line.substr(7));
-                } else if (line.starts_with("Destination:")) {
-                    destination = stoi(line.substr(12));
-                } else if (line.starts_with("AvoidNodes:")) {
-                    avoidNodes.clear();
-                    string nodes = line.substr(11);
-                    stringstream ss(nodes);
-                    string tok;
-                    while (getline(ss, tok, ',')) {
-                        if (!tok.empty()) avoidNodes.push_back(stoi(tok));
-                    }
-                } else if (line.starts_with("AvoidSegments:")) {
-                    avoidSegs.clear();
-                    string segments = line.substr(14);
-                    stringstream ss(segments);
-                    string seg;
-                    while (ss >> seg) {
-                        if (seg.front() == '(' && seg.back() == ')') {
-                            seg = seg.substr(1, seg.size() - 2);
-                            size_t comma = seg.find(',');
-                            if (comma != string::npos) {
-                                int a = stoi(seg.substr(0, comma));
-                                int b = stoi(seg.substr(comma + 1));
-                                avoidSegs.emplace_back(a, b);
-                            }
-                        }
+            case 3: {
+                cout << "\n--- Walking vs. Total Time Trade-offs ---\n";
+                int source; int destination;
+                while (true) {
+                    source = readAnyInteger("Enter Source ID: ", graph);
+                    destination = readAnyInteger("Enter Destination ID: ", graph);
+                    if (isValidEnv(graph, source, destination)) break;
+                }
+                double maxWalk = readAnyInteger("Enter Max Walking Time (minutes): ", graph);
+                vector<int> avoidNodes;
+                while (true) {
+                    avoidNodes = readCommaSeparatedInts("Enter Nodes to Avoid (comma-separated, leave blank if none): ", graph);
+                    if (find(avoidNodes.begin(), avoidNodes.end(), source) != avoidNodes.end() || find(avoidNodes.begin(), avoidNodes.end(), destination) != avoidNodes.end()) {
+                        cout << "Source and Destination cannot be in the set of nodes to avoid. Please try again.\n";
+                        continue;
                     }
-                } else if (line.starts_with("IncludeNode:")) {
-                    includeNode = stoi(line.substr(12));
-                } else if (line.starts_with("MaxWalkTime:")) {
-                    maxWalk = stod(line.substr(13));
+                    break;
                 }
-            }
+                auto avoidSegs  = readSegments("Enter Segments to Avoid (format: (id1,id2) space-separated, blank if none): ", graph);
 
-            // Dispatch to correct function
-            if (mode == "driving") {
-                double bestTime, altTime;
-                auto bestPath = findBestRoute(graph, source, destination, bestTime);
-                auto altPath = bestPath.empty() ? vector<int>() : findAlternativeRoute(graph, source, destination, bestPath, altTime);
-                outFile << "Source:" << source << "\nDestination:" << destination << "\n";
-                if (bestPath.empty()) {
-                    outFile << "BestDrivingRoute:none\nAlternativeDrivingRoute:none\n";
-                } else {
-                    outFile << "BestDrivingRoute:";
-                    for (size_t i = 0; i < bestPath.size(); ++i) {
-                        outFile << bestPath[i] << (i + 1 < bestPath.size() ? "," : "");
-                    }
-                    outFile << "(" << bestTime << ")\n";
+                auto front = findParetoEnvRoutes(csr, source, destination, maxWalk, avoidNodes, avoidSegs);
 
-                    if (altPath.empty()) {
-                        outFile << "AlternativeDrivingRoute:none\n";
-                    } else {
-                        outFile << "AlternativeDrivingRoute:";
-                        for (size_t i = 0; i < altPath.size(); ++i) {
-                            outFile << altPath[i] << (i + 1 < altPath.size() ? "," : "");
-                        }
-                        outFile << "(" << altTime << ")\n";
-                    }
+                cout << "Source:" << source << "\n";
+                cout << "Destination:" << destination << "\n";
+                if (front.empty()) {
+                    cout << "No driving and walking route within the max walking time.\n";
+                    break;
                 }
-            } else if (mode == "restricted") {
-                auto path = restrictedDrivingRoute(graph, source, destination, avoidNodes, avoidSegs, includeNode);
-                outFile << "Source:" << source << "\nDestination:" << destination << "\n";
-                if (path.empty()) {
-                    outFile << "RestrictedDrivingRoute:none\n";
-                } else {
-                    outFile << "RestrictedDrivingRoute:";
-                    int totalTime = 0;
-                    for (size_t i = 0; i < path.size(); ++i) {
-                        outFile << path[i];
-                        if (i + 1 < path.size()) outFile << ",";
-                        if (i + 1 < path.size()) {
-                            auto u = graph.findVertex(path[i]);
-                            for (auto e : u->getAdj()) {
-                                if (e->getDest()->getInfo() == path[i + 1]) {
-                                    totalTime += e->getDrivingWeight();
-                                    break;
-                                }
-                            }
-                        }
+                for (size_t i = 0; i < front.size(); ++i) {
+                    cout << "Option" << (i + 1) << ": TotalTime " << front[i].totalTime
+                         << ", WalkingTime " << front[i].walkingTime
+                         << ", ParkingNode " << front[i].parkingNode << "\n";
+                    cout << "  DrivingRoute: ";
+                    for (size_t j = 0; j < front[i].drivingPath.size(); ++j) {
+                        cout << front[i].drivingPath[j];
+                        if (j + 1 < front[i].drivingPath.size()) cout << ",";
                     }
-                    outFile << "(" << totalTime << ")\n";
-                }
-            } else if (mode == "env") {
-                auto route = findEnvFriendlyRoute(graph, source, destination, maxWalk, avoidNodes, avoidSegs);
-                outFile << "Source:" << source << "\nDestination:" << destination << "\n";
-                if (route.parkingNode == -1) {
-                    outFile << "DrivingRoute:none\nParkingNode:none\nWalkingRoute:none\nTotalTime:\nMessage:" << route.message << "\n";
-                } else {
-                    outFile << "DrivingRoute:";
-                    for (size_t i = 0; i < route.drivingPath.size(); ++i) {
-                        outFile << route.drivingPath[i] << (i + 1 < route.drivingPath.size() ? "," : "");
+                    cout << "(" << front[i].drivingTime << ")\n";
+                    cout << "  WalkingRoute: ";
+                    for (size_t j = 0; j < front[i].walkingPath.size(); ++j) {
+                        cout << front[i].walkingPath[j];
+                        if (j + 1 < front[i].walkingPath.size()) cout << ",";
                     }
-                    outFile << "(" << route.drivingTime << ")\n";
+                    cout << "(" << front[i].walkingTime << ")\n";
+                }
+                break;
+            }
 
-                    outFile << "ParkingNode:" << route.parkingNode << "\n";
+            case 5:
+                cout << "Returning to Main Menu...\n";
+                return; // exit sub-menu
+        }
+    }
+}
 
-                    outFile << "WalkingRoute:";
-                    for (size_t i = 0; i < route.walkingPath.size(); ++i) {
-                        outFile << route.walkingPath[i] << (i + 1 < route.walkingPath.size() ? "," : "");
-                    }
-                    outFile << "(" << route.walkingTime << ")\n";
+/**
+ * Handles the Tools sub-menu logic.
+ * Loops until user chooses option 6 (Back to Main Menu).
+ */
+void handleToolsSubMenu(const Graph<int>& graph, const CsrGraph& csr, unique_ptr<DistanceTable>& table) {
+    while (true) {
+        displayToolsMenu();
+        int subVal = readIntChoice("Enter your choice: ", {1, 2, 3, 4, 5, 6});
 
-                    outFile << "TotalTime:" << route.totalTime << "\n";
-                }
-            } else if (mode == "env_alt") {
-                auto results = AlternativeRoute::findTwoSolutions(graph, source, destination, maxWalk, avoidNodes, avoidSegs);
-                outFile << "Source:" << source << "\nDestination:" << destination << "\n";
-                if (results.empty()) {
-                    outFile << "Message:No alternative routes found.\n";
+        switch (subVal) {
+            case 1:
+                cout << "Benchmarking Priority Queues...\n";
+                runHeapBenchmark(csr, cout);
+                break;
+            case 2: {
+                cout << "Building Distance Table...\n";
+                auto start = chrono::steady_clock::now();
+                table = DistanceTable::build(csr);
+                double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+                cout << "Built in " << ms << " ms (" << table->getSizeBytes() / (1024 * 1024) << " MiB).\n";
+                if (table->save(DISTANCE_TABLE_FILE)) {
+                    cout << "Saved to " << DISTANCE_TABLE_FILE << "; batch runs will map it instead of searching.\n";
                 } else {
-                    for (size_t i = 0; i < results.size(); ++i) {
-                        const auto& r = results[i];
-                        outFile << "DrivingRoute" << (i+1) << ":";
-                        for (size_t j = 0; j < r.drivingPath.size(); ++j) {
-                            outFile << r.drivingPath[j] << (j + 1 < r.drivingPath.size() ? "," : "");
-                        }
-                        outFile << "(" << r.drivingTime << ")\n";
-                        outFile << "ParkingNode" << (i+1) << ":" << r.parkingNode << "\n";
-                        outFile << "WalkingRoute" << (i+1) << ":";
-                        for (size_t j = 0; j < r.walkingPath.size(); ++j) {
-                            outFile << r.walkingPath[j] << (j + 1 < r.walkingPath.size() ? "," : "");
-                        }
-                        outFile << "(" << r.walkingTime << ")\n";
-                        outFile << "TotalTime" << (i+1) << ":" << r.totalTime << "\n";
-                    }
+                    cout << "Could not write " << DISTANCE_TABLE_FILE << ".\n";
                 }
+                break;
             }
+            case 3:
+                if (writeGraphSnapshot(csr, GRAPH_SNAPSHOT_FILE)) {
+                    cout << "Saved to " << GRAPH_SNAPSHOT_FILE << "; batch runs will map it instead of reading the CSV files.\n";
+                } else {
+                    cout << "Could not write " << GRAPH_SNAPSHOT_FILE << ".\n";
+                }
+                break;
+            case 4:
+                cout << "Benchmarking CSV Loading...\n";
+                runCsvLoadBenchmark(LOCATIONS_FILE, DISTANCES_FILE, cout);
+                break;
+            case 5:
+                writeMemoryReport(&graph, csr, table.get(), cout);
+                break;
+            case 6:
+                cout << "Returning to Main Menu...\n";
+                return;
+        }
+    }
+}
+
+// ----------------------------------------------------------
+// BATCH MODE
+// ----------------------------------------------------------
+
+/**
+ * Solves the parsed blocks of batch/input.txt and writes batch/output.txt in input order.
+ * Queries run in parallel; the worker count comes from the BATCH_THREADS environment
+ * variable (default: one per hardware thread).
+ */
+void runBatchMode(const CsrGraph& csr, const vector<BatchQuery>& queries, const RoutingEngines& engines) {
+    ofstream outFile("batch/output.txt");
+    if (!outFile.is_open()) return;
 
-            outFile << "\n---\n";
+    unsigned numThreads = 0;
+    if (const char* threads = getenv("BATCH_THREADS")) {
+        try {
+            numThreads = stoul(threads);
+        } catch (...) {
+            cerr << "Ignoring invalid BATCH_THREADS value: " << threads << "\n";
         }
     }
+    runBatch(csr, queries, outFile, numThreads, engines);
 }
 
 
@@ -642,37 +709,67 @@ void runBatchMode(Graph<int>& graph) {
 // MAIN MENU FUNCTION
 // ----------------------------------------------------------
 
-void menu() {
-    // Load Data
-    Reader<int> reader;
-    Graph<int> graph;
-    reader.loadLocations(graph, "../mock_csv_data/Locations.csv");
-    reader.loadDistances(graph, "../mock_csv_data/Distances.csv");
+/**
+ * True if the exported graph snapshot exists and neither CSV file it was made from has changed
+ * since. Missing CSV files do not count, so a snapshot can be deployed on its own.
+ */
+bool graphSnapshotIsCurrent() {
+    error_code ec;
+    auto snapshotTime = filesystem::last_write_time(GRAPH_SNAPSHOT_FILE, ec);
+    if (ec) return false;
+    for (const string& csv : {LOCATIONS_FILE, DISTANCES_FILE}) {
+        auto csvTime = filesystem::last_write_time(csv, ec);
+        if (!ec && csvTime > snapshotTime) return false;
+    }
+    return true;
+}
 
+void menu() {
     ifstream test("batch/input.txt");
-    if (test.is_open()) {
-        string line;
-        getline(test, line);
-        if (line.starts_with("Mode:")) {
-            runBatchMode(graph);
-            return;
-        }
+    string line;
+    if (test.is_open() && getline(test, line) && line.starts_with("Mode:")) {
+        // Batch runs only need the CSR arrays, so an up-to-date snapshot spares the CSV parsing,
+        // and otherwise the CSV files are parsed straight into them
+        auto csr = graphSnapshotIsCurrent() ? loadGraphSnapshot(GRAPH_SNAPSHOT_FILE) : nullptr;
+        if (!csr) csr = loadCsvGraph(LOCATIONS_FILE, DISTANCES_FILE);
+        if (!csr) return;
+        test.seekg(0);
+        auto queries = parseBatchQueries(test);
+        auto table = DistanceTable::load(*csr, DISTANCE_TABLE_FILE); // only if built for this data
+        // Preprocess only the indices these queries will use, so short runs start quickly
+        auto needs = neededEngines(queries, table != nullptr);
+        auto ch = needs.ch ? make_unique<ContractionHierarchy>(*csr) : nullptr;
+        auto landmarks = needs.landmarks ? make_unique<LandmarkIndex>(*csr) : nullptr;
+        runBatchMode(*csr, queries, {ch.get(), landmarks.get(), table.get()});
+        return;
     }
 
+    // Load Data
+    Reader<int> reader;
+    Graph<int> graph;
+    reader.loadLocations(graph, LOCATIONS_FILE);
+    reader.loadDistances(graph, DISTANCES_FILE);
+    CsrGraph csr(graph); // frozen snapshot used by every route query
+    ContractionHierarchy ch(csr);
+    LandmarkIndex landmarks(csr);
+    auto table = DistanceTable::load(csr, DISTANCE_TABLE_FILE); // only if built for this data
 
     while (true) {
         displayMainMenu();
-        // only accept 1, 2, or 3
-        int mainChoice = readIntChoice("Enter your choice: ", {1, 2, 3});
+        // only accept 1, 2, 3 or 4
+        int mainChoice = readIntChoice("Enter your choice: ", {1, 2, 3, 4});
 
         switch(mainChoice) {
             case 1:
-                handleDrivingSubMenu(graph);
+                handleDrivingSubMenu(graph, csr, ch, landmarks, table.get());
                 break;
             case 2:
-                handleDrivingWalkingSubMenu(graph);
+                handleDrivingWalkingSubMenu(graph, csr, landmarks, table.get());
                 break;
             case 3:
+                handleToolsSubMenu(graph, csr, table);
+                break;
+            case 4:
                 cout << "Exiting Program...\n";
                 return;
         }
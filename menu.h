@@ -5,6 +5,11 @@
 #include <vector>
 #include <utility>
 #include "data_structures/Graph.h"
+#include "data_structures/CsrGraph.h"
+#include "ContractionHierarchy.h"
+#include "LandmarkIndex.h"
+#include "DistanceTable.h"
+#include <memory>
 using namespace std;
 
 /**
@@ -38,7 +43,7 @@ bool isValidNode(const Graph<int>& graph, int id);
 bool isValidEnv(const Graph<int>& graph, int source, int destination);
 
 /**
- * Displays the main menu (Driving Only / Driving & Walking / Exit).
+ * Displays the main menu (Driving Only / Driving & Walking / Tools / Exit).
  */
 void displayMainMenu();
 
@@ -48,29 +53,54 @@ void displayMainMenu();
 void displayDrivingMenu();
 
 /**
- * Displays the Driving+Walking Functions menu (Best Route, Restricted Route, Back).
+ * Displays the Driving+Walking Functions menu (Best Route, Approximate Solution, Trade-offs,
+ * Best Route by layered search, Back).
  */
 void displayDrivingWalkingMenu();
 
+/**
+ * Displays the Tools menu (Priority Queue Benchmark, Build Distance Table, Export Graph Snapshot,
+ * CSV Loading Benchmark, Memory Footprint Report, Back).
+ */
+void displayToolsMenu();
+
 /**
  * Handles the Driving-Only sub-menu logic:
  * - Repeatedly shows the Driving menu
  * - Reads user input for sub-choices
  * - Calls appropriate route functions (Best Route, Restricted Route) or returns to Main.
+ * - Best routes are table lookups when a distance table is loaded (table may be null).
  */
-void handleDrivingSubMenu(Graph<int>& graph);
+void handleDrivingSubMenu(Graph<int>& graph, const CsrGraph& csr, const ContractionHierarchy& ch,
+                          const LandmarkIndex& landmarks, const DistanceTable* table);
 
 /**
  * Handles the Driving+Walking sub-menu logic:
  * - Repeatedly shows the Driving+Walking menu
  * - Reads user input for sub-choices
  * - Calls appropriate route functions (Best Route, Restricted Route) or returns to Main.
+ * - Best routes without avoid lists are table lookups when a distance table is loaded (table may be null).
+ */
+void handleDrivingWalkingSubMenu(Graph<int>& graph, const CsrGraph& csr, const LandmarkIndex& landmarks,
+                                 const DistanceTable* table);
+
+/**
+ * Handles the Tools sub-menu logic:
+ * - Repeatedly shows the Tools menu
+ * - Runs the selected diagnostic on the CSR snapshot, (re)builds and saves the all-pairs
+ *   distance table into table, exports the CSR snapshot to a binary file, times CSV loading,
+ *   reports the memory held by graph, csr and table, or returns to Main.
  */
-void handleDrivingWalkingSubMenu(Graph<int>& graph);
+void handleToolsSubMenu(const Graph<int>& graph, const CsrGraph& csr, unique_ptr<DistanceTable>& table);
 
 /**
  * The main menu function:
- * - Loads the Locations/Distances data into the Graph.
+ * - Loads the Locations/Distances data into the Graph and freezes it into a CSR snapshot for routing.
+ *   Batch runs map the exported binary snapshot instead when the CSV files have not changed since,
+ *   or else parse the CSV files straight into the CSR arrays (see CsvLoader.h).
+ * - Builds the Contraction Hierarchy used for plain driving queries and the landmark index
+ *   used for restricted and environmentally-friendly queries, and maps the all-pairs distance
+ *   table if one was saved for the same data.
  * - Repeatedly shows the Main menu.
  * - Invokes the sub-menu handlers or exits.
  */
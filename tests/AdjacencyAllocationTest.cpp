@@ -0,0 +1,113 @@
+#include "../BestRoute.h"
+#include "../RestrictedRoute.h"
+#include "../data_structures/Graph.h"
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace std;
+
+/*
+ * Checks that walking a Graph<int>'s adjacency and answering Graph<int> queries copy no edge
+ * lists: every heap allocation in the process goes through the counting operator new below.
+ */
+
+size_t allocationCount = 0;
+
+void *operator new(size_t size) {
+    allocationCount++;
+    if (void *p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    free(p);
+}
+
+int failures = 0;
+
+void check(bool condition, const string &what) {
+    if (!condition) {
+        cerr << "FAILED: " << what << "\n";
+        failures++;
+    }
+}
+
+/*
+ * Chain 1 - 2 - ... - n with driving weight 1 per segment. extraEdges more segments per
+ * vertex lead back to its neighbours but cannot be driven, so they are scanned by every
+ * expansion without changing the route, the queue or the workspace.
+ */
+void buildChain(Graph<int> &graph, int n, int extraEdges) {
+    for (int id = 1; id <= n; id++) graph.addVertex(id);
+    for (int id = 1; id < n; id++) {
+        graph.addBidirectionalEdge(id, id + 1, 1, 1);
+        for (int k = 0; k < extraEdges; k++) graph.addBidirectionalEdge(id, id + 1, INF, 1);
+    }
+}
+
+/*
+ * Allocations made by one best route and one restricted route query, after a warm-up query
+ * has sized the workspace.
+ */
+size_t queryAllocations(const Graph<int> &graph, int n) {
+    SearchWorkspace ws;
+    double time;
+    findBestRoute(graph, 1, n, time, ws);
+    restrictedDrivingRoute(graph, 1, n, {}, {}, -1, ws);
+
+    size_t before = allocationCount;
+    auto best = findBestRoute(graph, 1, n, time, ws);
+    auto restricted = restrictedDrivingRoute(graph, 1, n, {}, {}, -1, ws);
+    size_t used = allocationCount - before;
+
+    check((int) best.size() == n && time == n - 1, "best route follows the chain");
+    check((int) restricted.size() == n, "restricted route follows the chain");
+    return used;
+}
+
+int main() {
+    const int n = 200;
+    Graph<int> sparse, dense;
+    buildChain(sparse, n, 0);
+    buildChain(dense, n, 20);
+
+    // Plain loops over the views allocate nothing
+    size_t before = allocationCount;
+    size_t edges = 0;
+    for (auto v : dense.getVertexSet()) {
+        for (auto e : v->getAdj()) edges += e->getDest() != nullptr;
+        for (auto e : v->getIncoming()) edges += e->getOrig() != nullptr;
+    }
+    size_t loopAllocations = allocationCount - before;
+    check(loopAllocations == 0, "getVertexSet/getAdj/getIncoming loops allocate");
+    check(edges == 4 * 21 * (size_t) (n - 1), "every edge is seen from both ends");
+
+    // Both queries expand all n vertices, so copying edge lists would cost at least 2n
+    // allocations; and the count must not depend on how many edges each vertex has
+    size_t sparseQuery = queryAllocations(sparse, n);
+    size_t denseQuery = queryAllocations(dense, n);
+    check(denseQuery < (size_t) n, "queries allocate per expanded vertex (" + to_string(denseQuery) + ")");
+    check(sparseQuery == denseQuery, "query allocations grow with the adjacency size ("
+                                     + to_string(sparseQuery) + " vs " + to_string(denseQuery) + ")");
+
+    if (failures == 0) cout << "All adjacency allocation checks passed\n";
+    return failures == 0 ? 0 : 1;
+}